@@ -0,0 +1,66 @@
+#ifndef ALLOC_TEST_H
+#define ALLOC_TEST_H
+
+// This is alloc_test.h
+#include "raylib.h"
+#include "globals.h"
+#include "alloc_tracker.h"
+
+void begin_allocation_frame() {
+    AllocationTracker::beginFrame();
+
+    // The frame that just ended must not have touched the heap if it was a steady-state gameplay frame
+    if (launch_options.alloc_test &&
+        allocation_test_frame_state == GAME_STATE &&
+        game_frame > ALLOCATION_TEST_WARMUP_FRAMES) {
+        const allocation_zone checked_zones[] = { UPDATE_ZONE, DRAW_ZONE };
+        for (allocation_zone zone : checked_zones) {
+            allocation_counts counts = AllocationTracker::getFrameCounts(zone);
+            if (counts.allocations == 0) continue;
+
+            TraceLog(LOG_ERROR, "ALLOC TEST: Frame %zu made %zu allocations (%zu bytes) in %s, the first one from %p",
+                     game_frame, counts.allocations, counts.bytes, AllocationTracker::getZoneName(zone),
+                     counts.first_call_site);
+            ++allocation_test_failures;
+        }
+    }
+
+    allocation_test_frame_state = game_state;
+}
+
+void script_allocation_test_input() {
+    // Start the game, run back and forth while jumping every now and then, and confirm every other screen
+    size_t tick = game_frame + 1;
+    input_state scripted;
+    scripted.is_down[MOVE_RIGHT_ACTION] = (tick / 240) % 4 != 3;
+    scripted.is_down[MOVE_LEFT_ACTION] = (tick / 240) % 4 == 3;
+    scripted.is_down[JUMP_ACTION] = tick % 50 < 5;
+    scripted.is_down[CONFIRM_ACTION] = game_state != GAME_STATE && tick % 30 == 0;
+
+    double now = GetTime();
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        scripted.was_pressed[action] = scripted.is_down[action] && !current_input.is_down[action];
+        scripted.pressed_at[action] = now;
+    }
+    current_input = scripted;
+}
+
+bool is_allocation_test_over() {
+    return launch_options.alloc_test && game_frame >= ALLOCATION_TEST_FRAMES;
+}
+
+int finish_allocation_test() {
+    if (!launch_options.alloc_test) return 0;
+
+    allocation_counts total = AllocationTracker::getTotalCounts();
+    TraceLog(LOG_INFO, "ALLOC TEST: %zu frames, %zu allocations (%zu bytes) in total",
+             game_frame, total.allocations, total.bytes);
+    if (allocation_test_failures > 0) {
+        TraceLog(LOG_ERROR, "ALLOC TEST: FAILED, %zu gameplay frames allocated after warm-up", allocation_test_failures);
+        return 1;
+    }
+    TraceLog(LOG_INFO, "ALLOC TEST: PASSED, no gameplay frame allocated after warm-up");
+    return 0;
+}
+
+#endif // ALLOC_TEST_H
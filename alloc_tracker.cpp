@@ -0,0 +1,137 @@
+#include "alloc_tracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// This is alloc_tracker.cpp
+
+struct zone_counters {
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes{0};
+    std::atomic<size_t> frees{0};
+    std::atomic<const void*> first_call_site{nullptr};
+};
+
+static thread_local allocation_zone current_zone = OTHER_ZONE;
+static zone_counters frame_counters[ALLOCATION_ZONE_COUNT];
+static allocation_counts previous_frame_counts[ALLOCATION_ZONE_COUNT];
+static zone_counters total_counters;
+
+AllocationTracker::Zone::Zone(allocation_zone zone) : previous(current_zone) {
+    current_zone = zone;
+}
+
+AllocationTracker::Zone::~Zone() {
+    current_zone = previous;
+}
+
+bool AllocationTracker::isEnabled() {
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* AllocationTracker::getZoneName(allocation_zone zone) {
+    switch (zone) {
+        case UPDATE_ZONE:     return "update_game";
+        case DRAW_ZONE:       return "draw_game";
+        case LEVEL_LOAD_ZONE: return "level load";
+        default:              return "other";
+    }
+}
+
+void AllocationTracker::beginFrame() {
+    for (size_t zone = 0; zone < ALLOCATION_ZONE_COUNT; ++zone) {
+        previous_frame_counts[zone].allocations = frame_counters[zone].allocations.exchange(0);
+        previous_frame_counts[zone].bytes = frame_counters[zone].bytes.exchange(0);
+        previous_frame_counts[zone].frees = frame_counters[zone].frees.exchange(0);
+        previous_frame_counts[zone].first_call_site = frame_counters[zone].first_call_site.exchange(nullptr);
+    }
+}
+
+allocation_counts AllocationTracker::getFrameCounts(allocation_zone zone) {
+    return previous_frame_counts[zone];
+}
+
+allocation_counts AllocationTracker::getTotalCounts() {
+    allocation_counts counts;
+    counts.allocations = total_counters.allocations.load();
+    counts.bytes = total_counters.bytes.load();
+    counts.frees = total_counters.frees.load();
+    return counts;
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+#if defined(__GNUC__)
+#define ALLOCATION_CALL_SITE() __builtin_return_address(0)
+#else
+#define ALLOCATION_CALL_SITE() nullptr
+#endif
+
+static void record_allocation(size_t size, const void* callSite) {
+    zone_counters& counters = frame_counters[current_zone];
+    if (counters.allocations.fetch_add(1, std::memory_order_relaxed) == 0) {
+        counters.first_call_site.store(callSite, std::memory_order_relaxed);
+    }
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    total_counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    total_counters.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void record_free() {
+    frame_counters[current_zone].frees.fetch_add(1, std::memory_order_relaxed);
+    total_counters.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* tracked_allocate(size_t size, const void* callSite) {
+    void* memory = std::malloc(size != 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    record_allocation(size, callSite);
+    return memory;
+}
+
+static void* tracked_allocate_aligned(size_t size, std::align_val_t alignment, const void* callSite) {
+    size_t align = static_cast<size_t>(alignment);
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    record_allocation(size, callSite);
+    return memory;
+}
+
+static void tracked_free(void* memory) {
+    if (memory == nullptr) return;
+    record_free();
+    std::free(memory);
+}
+
+void* operator new(size_t size) { return tracked_allocate(size, ALLOCATION_CALL_SITE()); }
+void* operator new[](size_t size) { return tracked_allocate(size, ALLOCATION_CALL_SITE()); }
+void* operator new(size_t size, std::align_val_t alignment) { return tracked_allocate_aligned(size, alignment, ALLOCATION_CALL_SITE()); }
+void* operator new[](size_t size, std::align_val_t alignment) { return tracked_allocate_aligned(size, alignment, ALLOCATION_CALL_SITE()); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return tracked_allocate(size, ALLOCATION_CALL_SITE()); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return tracked_allocate(size, ALLOCATION_CALL_SITE()); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* memory) noexcept { tracked_free(memory); }
+void operator delete[](void* memory) noexcept { tracked_free(memory); }
+void operator delete(void* memory, size_t) noexcept { tracked_free(memory); }
+void operator delete[](void* memory, size_t) noexcept { tracked_free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { tracked_free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { tracked_free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { tracked_free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { tracked_free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { tracked_free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { tracked_free(memory); }
+
+#endif // TRACK_ALLOCATIONS
@@ -0,0 +1,48 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+// This is alloc_tracker.h
+#include <cstddef>
+
+enum allocation_zone {
+    OTHER_ZONE,
+    UPDATE_ZONE,
+    DRAW_ZONE,
+    LEVEL_LOAD_ZONE,
+    ALLOCATION_ZONE_COUNT
+};
+
+struct allocation_counts {
+    size_t allocations = 0;
+    size_t bytes = 0;
+    size_t frees = 0;
+    const void* first_call_site = nullptr; // Return address of the first allocation, when known
+};
+
+// Counts heap allocations per frame and per zone through global operator new/delete hooks.
+// The hooks are only compiled in when the game is built with PLATFORMER_TRACK_ALLOCATIONS;
+// otherwise every count stays zero and isEnabled() returns false.
+class AllocationTracker {
+public:
+    // Attributes the allocations of the current thread to a zone for as long as it lives
+    class Zone {
+        allocation_zone previous;
+
+    public:
+        explicit Zone(allocation_zone zone);
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    };
+
+    static bool isEnabled();
+    static const char* getZoneName(allocation_zone zone);
+
+    // Starts counting a new frame; the counts of the previous frame are returned by getFrameCounts()
+    static void beginFrame();
+    static allocation_counts getFrameCounts(allocation_zone zone);
+    static allocation_counts getTotalCounts();
+};
+
+#endif // ALLOC_TRACKER_H
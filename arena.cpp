@@ -0,0 +1,104 @@
+#include "arena.h"
+#include "raylib.h"
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+
+// This is arena.cpp
+
+Arena::Arena(const char* name, size_t blockSize) :
+    name(name),
+    block_size(blockSize),
+    first_block(nullptr),
+    current_block(nullptr),
+    current_offset(0),
+    stats()
+{
+    // Blocks are only requested on the first allocation
+}
+
+Arena::~Arena() {
+    Block* block = first_block;
+    while (block != nullptr) {
+        Block* next = block->next;
+        std::free(block);
+        block = next;
+    }
+}
+
+unsigned char* Arena::getBlockMemory(Block* block) {
+    return reinterpret_cast<unsigned char*>(block) + sizeof(Block);
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    // Try the current block first, then the blocks kept from before the last reset
+    Block* block = current_block;
+    size_t offset = current_offset;
+    while (block != nullptr) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(getBlockMemory(block)) + offset;
+        size_t padding = (alignment - address % alignment) % alignment;
+        if (offset + padding + size <= block->capacity) {
+            current_block = block;
+            current_offset = offset + padding + size;
+
+            stats.used_bytes += padding + size;
+            stats.high_water_bytes = std::max(stats.high_water_bytes, stats.used_bytes);
+            ++stats.allocations;
+            return getBlockMemory(block) + offset + padding;
+        }
+
+        block = block->next;
+        offset = 0;
+    }
+
+    // None of them has room left, so grab a new block from the heap, large enough for oversized requests
+    size_t capacity = std::max(block_size, size + alignment);
+    Block* newBlock = static_cast<Block*>(std::malloc(sizeof(Block) + capacity));
+    if (newBlock == nullptr) {
+        TraceLog(LOG_ERROR, "ARENA: [%s] Failed to allocate a block of %zu bytes", name, capacity);
+        throw std::bad_alloc();
+    }
+    newBlock->next = nullptr;
+    newBlock->capacity = capacity;
+
+    if (first_block == nullptr) {
+        first_block = newBlock;
+    }
+    else {
+        Block* last = current_block != nullptr ? current_block : first_block;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = newBlock;
+    }
+
+    stats.capacity_bytes += capacity;
+    ++stats.heap_allocations;
+
+    current_block = newBlock;
+    current_offset = 0;
+    return allocate(size, alignment);
+}
+
+void Arena::reset() {
+    current_block = first_block;
+    current_offset = 0;
+    stats.used_bytes = 0;
+    stats.allocations = 0;
+}
+
+const char* Arena::getName() const {
+    return name;
+}
+
+const arena_stats& Arena::getStats() const {
+    return stats;
+}
+
+void Arena::logStats() const {
+    TraceLog(LOG_INFO, "ARENA: [%s] %zu bytes used in %zu allocations, %zu bytes high water, "
+                       "%zu bytes in %zu heap blocks",
+             name, stats.used_bytes, stats.allocations, stats.high_water_bytes,
+             stats.capacity_bytes, stats.heap_allocations);
+}
@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+// This is arena.h
+#include <cstddef>
+#include <type_traits>
+
+// A contiguous run of `count` objects, e.g., one allocated from an arena
+template <typename T>
+struct array_view {
+    T *data = nullptr;
+    size_t count = 0;
+
+    T *begin() const { return data; }
+    T *end() const { return data + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T &operator[](size_t index) const { return data[index]; }
+};
+
+struct arena_stats {
+    size_t used_bytes = 0;         // Handed out since the last reset
+    size_t capacity_bytes = 0;     // Owned by the arena, kept across resets
+    size_t high_water_bytes = 0;   // The most ever used between two resets
+    size_t allocations = 0;        // Since the last reset
+    size_t heap_allocations = 0;   // Blocks the arena ever had to request from the heap
+};
+
+// A bump allocator: allocations are carved out of large blocks and are never freed one by one.
+// Everything is released at once by reset(), in O(1), and the blocks are reused by the next allocations,
+// so an arena that has warmed up no longer touches the heap. Objects are never destroyed, which is
+// why only trivially copyable types can be allocated. Not thread-safe.
+class Arena {
+    struct Block {
+        Block* next;
+        size_t capacity;
+    };
+
+    const char* name;
+    size_t block_size;
+    Block* first_block;
+    Block* current_block;
+    size_t current_offset;
+    arena_stats stats;
+
+    static unsigned char* getBlockMemory(Block* block);
+
+public:
+    Arena(const char* name, size_t blockSize);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    array_view<T> allocateArray(size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Arenas never run destructors");
+        return { static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count };
+    }
+
+    void reset();
+
+    const char* getName() const;
+    const arena_stats& getStats() const;
+    void logStats() const;
+};
+
+#endif // ARENA_H
@@ -5,62 +5,310 @@
 #include "globals.h"
 
 #include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstring>
 #include <cassert>
+#include <stdexcept>
+#include <algorithm>
+
+// Turns the distance stored in a glyph's alpha into coverage, with an edge one screen pixel wide at any size
+inline const char *SDF_FONT_FRAGMENT_SHADER = R"(
+#version 330
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+out vec4 finalColor;
+
+void main() {
+    float distance = texture(texture0, fragTexCoord).a - 0.5;
+    float edge_width = length(vec2(dFdx(distance), dFdy(distance)));
+    float alpha = smoothstep(-edge_width, edge_width, distance);
+    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
+)";
+
+Font load_sdf_font(const char *file_name, const char *cache_file_name) {
+    Font font = {};
+    font.baseSize = SDF_FONT_BASE_SIZE;
+    font.glyphCount = SDF_FONT_GLYPH_COUNT;
+
+    // Generating the distance fields is slow, so they are generated once and then loaded from the cache
+    long source_mod_time = GetFileModTime(file_name);
+    if (!load_sdf_font_cache(font, cache_file_name, source_mod_time)) {
+        int file_size = 0;
+        unsigned char *file_data = LoadFileData(file_name, &file_size);
+        if (file_data == nullptr) {
+            TraceLog(LOG_ERROR, "Failed to open font: %s", file_name);
+            throw std::runtime_error("Failed to open font");
+        }
+        font.glyphs = LoadFontData(file_data, file_size, SDF_FONT_BASE_SIZE, nullptr, SDF_FONT_GLYPH_COUNT, FONT_SDF);
+        UnloadFileData(file_data);
+
+        Image atlas = GenImageFontAtlas(font.glyphs, &font.recs, SDF_FONT_GLYPH_COUNT, SDF_FONT_BASE_SIZE, 0, 1);
+        font.texture = LoadTextureFromImage(atlas);
+        save_sdf_font_cache(font, atlas, cache_file_name, source_mod_time);
+        UnloadImage(atlas);
+    }
+
+    // The distances have to be interpolated between texels for the edges to be smooth
+    SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
+    return font;
+}
+
+bool load_sdf_font_cache(Font &font, const char *cache_file_name, long source_mod_time) {
+    int size = 0;
+    unsigned char *data = FileExists(cache_file_name) ? LoadFileData(cache_file_name, &size) : nullptr;
+    if (data == nullptr) return false;
+
+    // The cache is only used if it was generated from the same font file with the same settings
+    sdf_font_cache_header header;
+    size_t glyphs_size = sizeof(sdf_font_cache_glyph) * SDF_FONT_GLYPH_COUNT;
+    bool is_valid = static_cast<size_t>(size) >= sizeof(header);
+    if (is_valid) {
+        std::memcpy(&header, data, sizeof(header));
+        is_valid = std::memcmp(header.magic, "SDFF", 4) == 0 &&
+                   header.version == SDF_FONT_CACHE_VERSION &&
+                   header.source_mod_time == source_mod_time &&
+                   header.base_size == SDF_FONT_BASE_SIZE &&
+                   header.glyph_count == SDF_FONT_GLYPH_COUNT &&
+                   static_cast<size_t>(size) == sizeof(header) + glyphs_size +
+                       GetPixelDataSize(header.atlas_width, header.atlas_height, header.atlas_format);
+    }
+    if (!is_valid) {
+        UnloadFileData(data);
+        return false;
+    }
+
+    // Allocated with raylib's allocator, as UnloadFont() frees them
+    font.glyphs = static_cast<GlyphInfo*>(MemAlloc(sizeof(GlyphInfo) * SDF_FONT_GLYPH_COUNT));
+    font.recs = static_cast<Rectangle*>(MemAlloc(sizeof(Rectangle) * SDF_FONT_GLYPH_COUNT));
+    const unsigned char *cursor = data + sizeof(header);
+    for (int i = 0; i < SDF_FONT_GLYPH_COUNT; ++i) {
+        sdf_font_cache_glyph glyph;
+        std::memcpy(&glyph, cursor, sizeof(glyph));
+        cursor += sizeof(glyph);
+
+        // The glyph images are only needed to generate an atlas, which is already in the cache
+        font.glyphs[i] = {glyph.value, glyph.offset_x, glyph.offset_y, glyph.advance_x, {}};
+        font.recs[i] = glyph.rectangle;
+    }
+
+    Image atlas = {
+        const_cast<unsigned char*>(cursor), header.atlas_width, header.atlas_height, 1, header.atlas_format
+    };
+    font.texture = LoadTextureFromImage(atlas);
+    UnloadFileData(data);
+
+    TraceLog(LOG_INFO, "Loaded the SDF font from %s", cache_file_name);
+    return true;
+}
+
+void save_sdf_font_cache(const Font &font, Image atlas, const char *cache_file_name, long source_mod_time) {
+    sdf_font_cache_header header = {
+        {'S', 'D', 'F', 'F'}, SDF_FONT_CACHE_VERSION, source_mod_time, font.baseSize, font.glyphCount,
+        atlas.width, atlas.height, atlas.format
+    };
+    size_t atlas_size = GetPixelDataSize(atlas.width, atlas.height, atlas.format);
+
+    std::vector<unsigned char> data(sizeof(header) + sizeof(sdf_font_cache_glyph) * font.glyphCount + atlas_size);
+    unsigned char *cursor = data.data();
+    std::memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+    for (int i = 0; i < font.glyphCount; ++i) {
+        const GlyphInfo &info = font.glyphs[i];
+        sdf_font_cache_glyph glyph = {info.value, info.offsetX, info.offsetY, info.advanceX, font.recs[i]};
+        std::memcpy(cursor, &glyph, sizeof(glyph));
+        cursor += sizeof(glyph);
+    }
+    std::memcpy(cursor, atlas.data, atlas_size);
+
+    // Failing to write the cache only costs the generation time on the next launch
+    if (!SaveFileData(cache_file_name, data.data(), static_cast<int>(data.size()))) {
+        TraceLog(LOG_WARNING, "Failed to save the SDF font cache to %s", cache_file_name);
+    }
+}
 
 void load_fonts() {
-    menu_font = LoadFontEx("data/fonts/ARCADE_N.ttf", 256, nullptr, 128);
+    menu_font = load_sdf_font("data/fonts/ARCADE_N.TTF", "data/fonts/ARCADE_N.sdf");
+    add_memory_usage(loaded_font_memory, estimate_font_memory(menu_font));
+    sdf_font_shader = LoadShaderFromMemory(nullptr, SDF_FONT_FRAGMENT_SHADER);
 }
 
 void unload_fonts() {
+    UnloadShader(sdf_font_shader);
+    subtract_memory_usage(loaded_font_memory, estimate_font_memory(menu_font));
     UnloadFont(menu_font);
 }
 
+Texture2D load_texture(const char *file_name) {
+    // Every image goes through here and unload_texture(), so the image account is kept by the loaders themselves
+    Texture2D texture = LoadTexture(file_name);
+    loaded_image_memory.gpu_bytes += estimate_texture_bytes(texture);
+    return texture;
+}
+
+void unload_texture(Texture2D texture) {
+    loaded_image_memory.gpu_bytes -= estimate_texture_bytes(texture);
+    UnloadTexture(texture);
+}
+
 void load_images() {
-    wall_image                   = LoadTexture("data/images/wall.png");
-    wall_dark_image              = LoadTexture("data/images/wall_dark.png");
-    spike_image                  = LoadTexture("data/images/spikes.png");
-    exit_image                   = LoadTexture("data/images/exit.png");
+    wall_image                   = load_texture("data/images/wall.png");
+    wall_dark_image              = load_texture("data/images/wall_dark.png");
+    spike_image                  = load_texture("data/images/spikes.png");
+    exit_image                   = load_texture("data/images/exit.png");
 
     coin_sprite                  = load_sprite("data/images/coin/coin", ".png", 3, true, 18);
-    heart_image                  = LoadTexture("data/images/heart.png");
+    heart_image                  = load_texture("data/images/heart.png");
 
-    player_stand_forward_image   = LoadTexture("data/images/player_stand_forward.png");
-    player_stand_backwards_image = LoadTexture("data/images/player_stand_backwards.png");
-    player_jump_forward_image    = LoadTexture("data/images/player_jump_forward.png");
-    player_jump_backwards_image  = LoadTexture("data/images/player_jump_backwards.png");
-    player_dead_image            = LoadTexture("data/images/player_dead.png");
+    player_stand_forward_image   = load_texture("data/images/player_stand_forward.png");
+    player_stand_backwards_image = load_texture("data/images/player_stand_backwards.png");
+    player_jump_forward_image    = load_texture("data/images/player_jump_forward.png");
+    player_jump_backwards_image  = load_texture("data/images/player_jump_backwards.png");
+    player_dead_image            = load_texture("data/images/player_dead.png");
     player_walk_forward_sprite   = load_sprite("data/images/player_walk_forward/player", ".png", 3, true, 15);
     player_walk_backwards_sprite = load_sprite("data/images/player_walk_backwards/player", ".png", 3, true, 15);
 
     enemy_walk                   = load_sprite("data/images/enemy_walk/enemy", ".png", 2, true, 15);
 
-    background                   = LoadTexture("data/images/background/background.png");
-    middleground                 = LoadTexture("data/images/background/middleground.png");
-    foreground                   = LoadTexture("data/images/background/foreground.png");
+    load_background_layers();
 }
 
 void unload_images() {
-    UnloadTexture(wall_image);
-    UnloadTexture(wall_dark_image);
-    UnloadTexture(spike_image);
-    UnloadTexture(exit_image);
+    unload_texture(wall_image);
+    unload_texture(wall_dark_image);
+    unload_texture(spike_image);
+    unload_texture(exit_image);
 
     unload_sprite(coin_sprite);
-    UnloadTexture(heart_image);
+    unload_texture(heart_image);
 
-    UnloadTexture(player_stand_forward_image);
-    UnloadTexture(player_stand_backwards_image);
-    UnloadTexture(player_jump_forward_image);
-    UnloadTexture(player_jump_backwards_image);
-    UnloadTexture(player_dead_image);
+    unload_texture(player_stand_forward_image);
+    unload_texture(player_stand_backwards_image);
+    unload_texture(player_jump_forward_image);
+    unload_texture(player_jump_backwards_image);
+    unload_texture(player_dead_image);
     unload_sprite(player_walk_forward_sprite);
     unload_sprite(player_walk_backwards_sprite);
 
     unload_sprite(enemy_walk);
 
-    UnloadTexture(background);
-    UnloadTexture(middleground);
-    UnloadTexture(foreground);
+    unload_background_layers();
+}
+
+void load_background_layers() {
+    // One layer per line: the image, then its speed; lines starting with a semicolon are comments
+    std::ifstream file(PARALLAX_LAYERS_FILE);
+    if (!file.is_open()) {
+        TraceLog(LOG_ERROR, "Failed to open parallax layers file: %s", PARALLAX_LAYERS_FILE);
+        throw std::runtime_error(std::string("Failed to open parallax layers file: ") + PARALLAX_LAYERS_FILE);
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == ';') continue;
+
+        std::istringstream fields(line);
+        std::string path;
+        parallax_layer layer;
+        if (!(fields >> path >> layer.speed)) {
+            TraceLog(LOG_ERROR, "%s:%zu: expected an image and a speed", PARALLAX_LAYERS_FILE, line_number);
+            throw std::runtime_error("Malformed parallax layer in " + std::string(PARALLAX_LAYERS_FILE));
+        }
+
+        // Scrolling moves the texture coordinates past the edges, where the texture starts over
+        layer.texture = load_texture(path.c_str());
+        SetTextureWrap(layer.texture, TEXTURE_WRAP_REPEAT);
+        background_layers.push_back(layer);
+    }
+    loaded_image_memory.cpu_bytes += background_layers.capacity() * sizeof(parallax_layer);
+
+    // Only a stack of them is worth composing
+    composed_background_layers = 0;
+    while (composed_background_layers < background_layers.size() && background_layers[composed_background_layers].speed == 0.0f) {
+        ++composed_background_layers;
+    }
+    if (composed_background_layers < 2) {
+        composed_background_layers = 0;
+    }
+}
+
+void unload_background_layers() {
+    for (auto &layer : background_layers) {
+        unload_texture(layer.texture);
+    }
+    loaded_image_memory.cpu_bytes -= background_layers.capacity() * sizeof(parallax_layer);
+    std::vector<parallax_layer>().swap(background_layers);
+}
+
+Texture2D get_tile_texture(tile_texture texture) {
+    switch (texture) {
+        case WALL_TILE_TEXTURE:      return wall_image;
+        case WALL_DARK_TILE_TEXTURE: return wall_dark_image;
+        case SPIKE_TILE_TEXTURE:     return spike_image;
+        default:                     return {};
+    }
+}
+
+void match_texture_sampling(Texture2D &texture, float drawn_width) {
+    // Magnified textures are sampled at their nearest texel, which keeps the pixel art sharp and never touches
+    // mipmaps; only a texture drawn smaller than it is gets them, so that it reads fewer texels and doesn't shimmer
+    if (drawn_width >= static_cast<float>(texture.width)) {
+        SetTextureFilter(texture, TEXTURE_FILTER_POINT);
+        return;
+    }
+
+    if (texture.mipmaps <= 1) {
+        size_t bytes_without_mipmaps = estimate_texture_bytes(texture);
+        GenTextureMipmaps(&texture);
+        loaded_image_memory.gpu_bytes += estimate_texture_bytes(texture) - bytes_without_mipmaps;
+    }
+    SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+}
+
+void match_sprite_sampling(sprite &sprite, float drawn_width) {
+    for (size_t i = 0; i < sprite.frame_count; ++i) {
+        match_texture_sampling(sprite.frames[i], drawn_width);
+    }
+}
+
+void match_image_sampling_to_metrics() {
+    // Called whenever the sizes things are drawn at change, e.g., when the window is resized
+    float icon_size = HUD_ICON_SIZE * screen_scale;
+
+    match_texture_sampling(wall_image, cell_size);
+    match_texture_sampling(wall_dark_image, cell_size);
+    match_texture_sampling(spike_image, cell_size);
+    match_texture_sampling(exit_image, cell_size);
+
+    // Coins are both level elements and the HUD's score icon
+    match_sprite_sampling(coin_sprite, std::min(cell_size, icon_size));
+    match_texture_sampling(heart_image, icon_size);
+
+    match_texture_sampling(player_stand_forward_image, cell_size);
+    match_texture_sampling(player_stand_backwards_image, cell_size);
+    match_texture_sampling(player_jump_forward_image, cell_size);
+    match_texture_sampling(player_jump_backwards_image, cell_size);
+    match_texture_sampling(player_dead_image, cell_size);
+    match_sprite_sampling(player_walk_forward_sprite, cell_size);
+    match_sprite_sampling(player_walk_backwards_sprite, cell_size);
+
+    match_sprite_sampling(enemy_walk, cell_size);
+
+    for (auto &layer : background_layers) {
+        match_texture_sampling(layer.texture, background_size.x);
+    }
 }
 
 void draw_image(Texture2D image, Vector2 pos, float size) {
@@ -83,7 +331,7 @@ sprite load_sprite(
     assert(frame_count < 100);
 
     sprite result = {
-        frame_count, frames_to_skip, 0, 0, loop, 0, new Texture2D[frame_count]
+        frame_count, frames_to_skip, loop, new Texture2D[frame_count]
     };
 
     for (size_t i = 0; i < frame_count; ++i) {
@@ -97,8 +345,9 @@ sprite load_sprite(
             file_name += i < 10 ? ("0" + std::to_string(i)) : std::to_string(i);
             file_name += file_name_suffix;
         }
-        result.frames[i] = LoadTexture(file_name.c_str());
+        result.frames[i] = load_texture(file_name.c_str());
     }
+    loaded_image_memory.cpu_bytes += frame_count * sizeof(Texture2D);
 
     return result;
 }
@@ -107,50 +356,90 @@ void unload_sprite(sprite &sprite) {
     assert(sprite.frames != nullptr);
 
     for (size_t i = 0; i < sprite.frame_count; ++i) {
-        UnloadTexture(sprite.frames[i]);
+        unload_texture(sprite.frames[i]);
     }
+    loaded_image_memory.cpu_bytes -= sprite.frame_count * sizeof(Texture2D);
     delete[] sprite.frames;
     sprite.frames = nullptr;
 }
 
-void draw_sprite(sprite &sprite, Vector2 pos, float size) {
-    draw_sprite(sprite, pos, size, size);
+void advance_animation_clock() {
+    // At lower qualities the clock jumps several ticks at once, so sprites change less often at the same speed
+    ++animation_ticks;
+    animation_clock = animation_ticks - animation_ticks % get_quality_settings().animation_interval;
 }
 
-void draw_sprite(sprite &sprite, Vector2 pos, float width, float height) {
-    draw_image(sprite.frames[sprite.frame_index], pos, width, height);
+size_t get_sprite_frame_index(const sprite &sprite) {
+    // Every frame of the sprite is shown for `frames_to_skip + 1` ticks of the animation clock
+    size_t frame = animation_clock / (sprite.frames_to_skip + 1);
+    if (sprite.loop) {
+        return frame % sprite.frame_count;
+    }
+    return std::min(frame, sprite.frame_count - 1);
+}
 
-    if (sprite.prev_game_frame == game_frame) {
-        return;
+Sound load_sound(const char *file_name) {
+    Sound sound = LoadSound(file_name);
+    loaded_sound_memory.cpu_bytes += estimate_sound_bytes(sound);
+    return sound;
+}
+
+void unload_sound(Sound sound) {
+    loaded_sound_memory.cpu_bytes -= estimate_sound_bytes(sound);
+    UnloadSound(sound);
+}
+
+void load_sound_voices(sound_id id, Sound &sound, size_t voice_count, int priority, size_t min_ticks_between) {
+    sound_voice_pool &pool = sound_pools[id];
+    pool.voice_count = std::min(voice_count, MAX_VOICES_PER_SOUND);
+    pool.priority = priority;
+    pool.min_ticks_between = min_ticks_between;
+
+    // The first voice is the sound itself, the others are aliases sharing its samples
+    pool.voices[0] = sound;
+    for (size_t i = 1; i < pool.voice_count; ++i) {
+        pool.voices[i] = LoadSoundAlias(sound);
     }
-    if (sprite.frames_skipped < sprite.frames_to_skip) {
-        ++sprite.frames_skipped;
-    } else {
-        sprite.frames_skipped = 0;
+}
 
-        ++sprite.frame_index;
-        if (sprite.frame_index >= sprite.frame_count) {
-            sprite.frame_index = sprite.loop ? 0 : sprite.frame_count - 1;
-        }
+void unload_sound_voices(sound_id id) {
+    sound_voice_pool &pool = sound_pools[id];
+    for (size_t i = 1; i < pool.voice_count; ++i) {
+        UnloadSoundAlias(pool.voices[i]);
     }
-    sprite.prev_game_frame = game_frame;
+    pool = {};
 }
 
 void load_sounds() {
     InitAudioDevice();
-    coin_sound         = LoadSound("data/sounds/coin.wav");
-    exit_sound         = LoadSound("data/sounds/exit.wav");
-    kill_enemy_sound   = LoadSound("data/sounds/kill_enemy.wav");
-    player_death_sound = LoadSound("data/sounds/player_death.wav");
-    game_over_sound    = LoadSound("data/sounds/game_over.wav");
+    coin_sound         = load_sound("data/sounds/coin.wav");
+    exit_sound         = load_sound("data/sounds/exit.wav");
+    kill_enemy_sound   = load_sound("data/sounds/kill_enemy.wav");
+    player_death_sound = load_sound("data/sounds/player_death.wav");
+    game_over_sound    = load_sound("data/sounds/game_over.wav");
+
+    // Sound, number of voices, priority, and the minimum number of ticks between two plays
+    load_sound_voices(COIN_SOUND,         coin_sound,         4,        0,                 3);
+    load_sound_voices(KILL_ENEMY_SOUND,   kill_enemy_sound,   2,        1,                 1);
+    load_sound_voices(EXIT_SOUND,         exit_sound,         1,        2,                 1);
+    load_sound_voices(PLAYER_DEATH_SOUND, player_death_sound, 1,        3,                 1);
+    load_sound_voices(GAME_OVER_SOUND,    game_over_sound,    1,        3,                 1);
+
+    start_sound_mixer();
 }
 
 void unload_sounds() {
-    UnloadSound(coin_sound);
-    UnloadSound(exit_sound);
-    UnloadSound(kill_enemy_sound);
-    UnloadSound(player_death_sound);
-    UnloadSound(game_over_sound);
+    stop_sound_mixer();
+
+    for (size_t id = 0; id < SOUND_COUNT; ++id) {
+        unload_sound_voices(static_cast<sound_id>(id));
+    }
+
+    unload_sound(coin_sound);
+    unload_sound(exit_sound);
+    unload_sound(kill_enemy_sound);
+    unload_sound(player_death_sound);
+    unload_sound(game_over_sound);
 }
 
 #endif // IMAGES_H
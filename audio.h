@@ -0,0 +1,98 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+// This is audio.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <chrono>
+#include <thread>
+
+void play_sound(sound_id id) {
+    // Never blocks the game thread; if the mixer has fallen that far behind, the sound is simply skipped
+    if (!sound_queue.tryPush({id, game_frame})) {
+        dropped_sound_events.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void mix_sound_event(const sound_event &event) {
+    sound_voice_pool &pool = sound_pools[event.id];
+
+    // Coalesce repeats of the same sound within a tick, and rate-limit the ones closer than the pool allows
+    if (pool.has_played && event.tick - pool.last_played_tick < std::max<size_t>(pool.min_ticks_between, 1)) {
+        return;
+    }
+
+    // Prefer an idle voice of the pool, otherwise restart its oldest one
+    size_t voice = 0;
+    bool is_idle = false;
+    for (size_t i = 0; i < pool.voice_count; ++i) {
+        if (!IsSoundPlaying(pool.voices[i])) {
+            voice = i;
+            is_idle = true;
+            break;
+        }
+        if (pool.voice_started_at[i] < pool.voice_started_at[voice]) {
+            voice = i;
+        }
+    }
+
+    if (is_idle) {
+        // Starting another voice must stay within the global budget, so steal one from the
+        // least important (and then oldest) playing sound, provided it is not more important than this one
+        size_t active_voices = 0;
+        sound_voice_pool *victim_pool = nullptr;
+        size_t victim_voice = 0;
+        for (auto &other : sound_pools) {
+            for (size_t i = 0; i < other.voice_count; ++i) {
+                if (!IsSoundPlaying(other.voices[i])) continue;
+                ++active_voices;
+
+                if (other.priority > pool.priority) continue;
+                if (victim_pool == nullptr ||
+                    other.priority < victim_pool->priority ||
+                    (other.priority == victim_pool->priority &&
+                     other.voice_started_at[i] < victim_pool->voice_started_at[victim_voice])) {
+                    victim_pool = &other;
+                    victim_voice = i;
+                }
+            }
+        }
+
+        if (active_voices >= MAX_ACTIVE_VOICES) {
+            if (victim_pool == nullptr) {
+                return;
+            }
+            StopSound(victim_pool->voices[victim_voice]);
+        }
+    }
+
+    PlaySound(pool.voices[voice]);
+    pool.voice_started_at[voice] = ++sound_voice_sequence;
+    pool.last_played_tick = event.tick;
+    pool.has_played = true;
+}
+
+void run_sound_mixer() {
+    while (is_sound_mixer_running.load(std::memory_order_acquire)) {
+        sound_event event;
+        while (sound_queue.tryPop(event)) {
+            mix_sound_event(event);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(SOUND_MIXER_POLL_INTERVAL_MS));
+    }
+}
+
+void start_sound_mixer() {
+    is_sound_mixer_running.store(true, std::memory_order_release);
+    sound_mixer_thread = std::thread(run_sound_mixer);
+}
+
+void stop_sound_mixer() {
+    is_sound_mixer_running.store(false, std::memory_order_release);
+    if (sound_mixer_thread.joinable()) {
+        sound_mixer_thread.join();
+    }
+}
+
+#endif // AUDIO_H
@@ -0,0 +1,159 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+// This is capture.h
+#include "raylib.h"
+#include "rlgl.h"
+#include "globals.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+bool is_capturing_frames() {
+    return launch_options.capture_directory != nullptr || launch_options.capture_command != nullptr;
+}
+
+void write_captured_frame(const captured_frame &frame) {
+    if (capture_pipe != nullptr) {
+        size_t size = GetPixelDataSize(frame.image.width, frame.image.height, frame.image.format);
+        // Once the encoder is gone, the frames still queued have nowhere to go
+        if (has_capture_encoder_exited) return;
+
+        if (std::fwrite(frame.image.data, 1, size, capture_pipe) != size) {
+            if (errno == EPIPE) {
+                has_capture_encoder_exited = true;
+                TraceLog(LOG_WARNING, "CAPTURE: the encoder exited at frame %zu, no more frames are captured", frame.index);
+            }
+            else {
+                TraceLog(LOG_WARNING, "CAPTURE: failed to write frame %zu to the encoder", frame.index);
+            }
+            return;
+        }
+    }
+    else {
+        // Not TextFormat(), whose buffers are shared by every thread
+        char file_name[1024];
+        std::snprintf(file_name, sizeof(file_name), "%s/frame_%06zu.png", launch_options.capture_directory, frame.index);
+        if (!ExportImage(frame.image, file_name)) {
+            TraceLog(LOG_WARNING, "CAPTURE: failed to write %s", file_name);
+            return;
+        }
+    }
+    ++written_capture_frames;
+}
+
+void run_capture_worker() {
+    std::unique_lock<std::mutex> lock(capture_mutex);
+    while (true) {
+        capture_frame_queued.wait(lock, [] { return capture_ring_count > 0 || !is_capture_running; });
+        // Stopping only happens once every queued frame is written
+        if (capture_ring_count == 0) return;
+
+        // The frame is taken out of the ring, so its slot is free again while the frame is encoded
+        captured_frame frame = capture_ring[capture_ring_first];
+        capture_ring_first = (capture_ring_first + 1) % CAPTURE_RING_SIZE;
+        --capture_ring_count;
+
+        lock.unlock();
+        write_captured_frame(frame);
+        UnloadImage(frame.image);
+        lock.lock();
+    }
+}
+
+void start_frame_capture() {
+    if (!is_capturing_frames()) return;
+
+    size_t worker_count = CAPTURE_WORKER_COUNT;
+    if (launch_options.capture_command != nullptr) {
+        capture_pipe = popen(launch_options.capture_command, "w");
+        if (capture_pipe == nullptr) {
+            TraceLog(LOG_ERROR, "Failed to start the capture encoder: %s", launch_options.capture_command);
+            throw std::runtime_error("Failed to start the capture encoder");
+        }
+        worker_count = 1;
+
+#ifndef _WIN32
+        // Writing to an encoder that has exited would raise SIGPIPE and end the game; ignored, the write fails with EPIPE
+        previous_sigpipe_handler = std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+        // The encoder has to be told the size of the frames, which is the window's when the capture starts
+        capture_width = GetRenderWidth();
+        capture_height = GetRenderHeight();
+        TraceLog(LOG_INFO, "CAPTURE: piping %dx%d RGBA frames to %s", capture_width, capture_height, launch_options.capture_command);
+    }
+    else if (!DirectoryExists(launch_options.capture_directory)) {
+        TraceLog(LOG_ERROR, "Capture directory does not exist: %s", launch_options.capture_directory);
+        throw std::runtime_error("Capture directory does not exist");
+    }
+
+    is_capture_running = true;
+    for (size_t i = 0; i < worker_count; ++i) {
+        capture_workers.emplace_back(run_capture_worker);
+    }
+}
+
+void capture_frame() {
+    // Called once the frame is drawn, before EndDrawing() presents it
+    if (!is_capture_running || has_capture_encoder_exited) return;
+
+    size_t index = capture_frame_count++;
+    {
+        std::lock_guard<std::mutex> lock(capture_mutex);
+        if (capture_ring_count == CAPTURE_RING_SIZE) {
+            ++dropped_capture_frames;
+            return;
+        }
+    }
+
+    // raylib has no asynchronous readback, so this waits for the GPU to finish the frame and flips the rows here;
+    // only encoding and writing are up to the workers. The batch is drawn first, or the last quads would be missing.
+    rlDrawRenderBatchActive();
+    Image image = LoadImageFromScreen();
+    if (capture_pipe != nullptr && (image.width != capture_width || image.height != capture_height)) {
+        UnloadImage(image);
+        ++dropped_capture_frames;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(capture_mutex);
+        capture_ring[(capture_ring_first + capture_ring_count) % CAPTURE_RING_SIZE] = {image, index};
+        ++capture_ring_count;
+    }
+    capture_frame_queued.notify_one();
+}
+
+void stop_frame_capture() {
+    if (!is_capture_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(capture_mutex);
+        is_capture_running = false;
+    }
+    capture_frame_queued.notify_all();
+    for (auto &worker : capture_workers) {
+        worker.join();
+    }
+    capture_workers.clear();
+
+    if (capture_pipe != nullptr) {
+        pclose(capture_pipe);
+        capture_pipe = nullptr;
+#ifndef _WIN32
+        std::signal(SIGPIPE, previous_sigpipe_handler);
+#endif
+    }
+    TraceLog(LOG_INFO, "CAPTURE: %zu of %zu frames written, %zu dropped",
+             written_capture_frames.load(), capture_frame_count, dropped_capture_frames);
+}
+
+#endif // CAPTURE_H
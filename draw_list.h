@@ -0,0 +1,100 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+// This is draw_list.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void submit_texture(draw_layer layer, Texture2D texture, Rectangle source, Rectangle destination, size_t depth) {
+    draw_command command;
+    command.layer = layer;
+    command.depth = depth;
+    command.texture = texture;
+    command.source = source;
+    command.destination = destination;
+    command.order = draw_list.size();
+    draw_list.push_back(command);
+}
+
+void submit_image(draw_layer layer, Texture2D image, Vector2 pos, float size) {
+    submit_image(layer, image, pos, size, size);
+}
+
+void submit_image(draw_layer layer, Texture2D image, Vector2 pos, float width, float height) {
+    Rectangle source = { 0.0f, 0.0f, static_cast<float>(image.width), static_cast<float>(image.height) };
+    submit_texture(layer, image, source, { pos.x, pos.y, width, height });
+}
+
+void submit_text(draw_layer layer, const Font &font, const char *text, Vector2 pos, float size, float spacing, Color color) {
+    draw_command command;
+    command.layer = layer;
+    command.texture = font.texture;
+    command.destination = { pos.x, pos.y, 0.0f, size };
+    command.tint = color;
+    command.font = &font;
+    command.spacing = spacing;
+    std::snprintf(command.text, sizeof(command.text), "%s", text);
+    command.order = draw_list.size();
+    draw_list.push_back(command);
+}
+
+void flush_draw_list(draw_layer first, draw_layer last) {
+    // Group the commands by layer and depth, and by texture inside every depth, keeping the submission order otherwise,
+    // so that raylib only has to flush its batch when the texture changes
+    std::sort(draw_list.begin(), draw_list.end(), [](const draw_command &a, const draw_command &b) {
+        if (a.layer != b.layer) return a.layer < b.layer;
+        if (a.depth != b.depth) return a.depth < b.depth;
+        if (a.texture.id != b.texture.id) return a.texture.id < b.texture.id;
+        return a.order < b.order;
+    });
+
+    // Only the commands of the requested layers are drawn, the others stay in the list for a later flush
+    auto begin = std::find_if(draw_list.begin(), draw_list.end(), [first](const draw_command &command) {
+        return command.layer >= first;
+    });
+    auto end = std::find_if(begin, draw_list.end(), [last](const draw_command &command) {
+        return command.layer > last;
+    });
+
+    unsigned int current_texture = 0;
+    bool is_drawing_text = false;
+    for (auto command = begin; command != end; ++command) {
+        if (command->texture.id != current_texture) {
+            current_texture = command->texture.id;
+            ++frame_draw_stats.batches;
+        }
+
+        // Text commands of a font share its texture, so they are already together and the shader is switched
+        // once per run of them rather than once per text
+        bool is_text = command->font != nullptr;
+        if (is_text != is_drawing_text) {
+            if (is_text) BeginShaderMode(sdf_font_shader);
+            else EndShaderMode();
+            is_drawing_text = is_text;
+        }
+
+        if (is_text) {
+            Vector2 pos = { command->destination.x, command->destination.y };
+            DrawTextEx(*command->font, command->text, pos, command->destination.height, command->spacing, command->tint);
+        }
+        else {
+            DrawTexturePro(command->texture, command->source, command->destination, { 0.0f, 0.0f }, 0.0f, command->tint);
+        }
+    }
+
+    if (is_drawing_text) {
+        EndShaderMode();
+    }
+
+    frame_draw_stats.draw_calls += end - begin;
+    draw_list.erase(begin, end);
+}
+
+void reset_draw_stats() {
+    frame_draw_stats = {};
+}
+
+#endif // DRAW_LIST_H
@@ -0,0 +1,263 @@
+#ifndef EMBEDDED_LEVELS_H
+#define EMBEDDED_LEVELS_H
+
+// This is embedded_levels.h
+#include "globals.h"
+#include "level.h"
+#include "tiles.h"
+
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+
+// Decodes an RLE level pack while the game is compiled, into the same chunks and entity lists
+// Level::loadLevelFromRLE() would build from it, so that loading an embedded level is only copying.
+// The rules are the ones of Level::scanEncodedLevel(); a malformed level fails the build.
+
+inline const size_t LEVEL_CHUNK_CELLS = LEVEL_CHUNK_SIZE * LEVEL_CHUNK_SIZE;
+
+struct embedded_level_info {
+    size_t rows = 0, columns = 0;
+    size_t first_chunk = 0, chunk_count = 0;
+    size_t first_enemy = 0, enemy_count = 0;
+    size_t first_coin = 0, coin_count = 0;
+    size_t first_exit = 0, exit_count = 0;
+    bool has_spawn_point = false;
+    level_position spawn_point;
+};
+
+// A chunk that is not all air, and where it goes in its level's chunk directory
+struct embedded_chunk {
+    size_t index = 0;
+    char cells[LEVEL_CHUNK_CELLS] = {};
+};
+
+struct embedded_pack_size {
+    size_t levels = 0, chunks = 0, enemies = 0, coins = 0, exits = 0;
+};
+
+template <size_t LEVELS, size_t CHUNKS, size_t ENEMIES, size_t COINS, size_t EXITS>
+struct embedded_level_pack {
+    // Arrays can't be empty, so every one of them has at least one element
+    size_t level_count = 0;
+    embedded_level_info levels[std::max<size_t>(LEVELS, 1)];
+    embedded_chunk chunks[std::max<size_t>(CHUNKS, 1)];
+    level_position enemies[std::max<size_t>(ENEMIES, 1)];
+    level_position coins[std::max<size_t>(COINS, 1)];
+    level_position exits[std::max<size_t>(EXITS, 1)];
+};
+
+// Reads the runs of one row, one cell at a time; cells past the end of the row are air
+struct embedded_run_cursor {
+    std::string_view content;
+    size_t i = 0, end = 0;
+    char element = AIR;
+    size_t remaining = 0;
+
+    constexpr bool isDigit(size_t at) const {
+        return content[at] >= '0' && content[at] <= '9';
+    }
+
+    constexpr size_t readRun() {
+        size_t count = 1;
+        if (isDigit(i)) {
+            count = 0;
+            while (i < end && isDigit(i)) {
+                if (count > (MAX_RUN_LENGTH - 9) / 10) {
+                    throw std::runtime_error("malformed level, run length is too large");
+                }
+                count = count * 10 + (content[i++] - '0');
+            }
+            if (i == end) {
+                throw std::runtime_error("malformed level, run length is not followed by a level element");
+            }
+            if (count == 0) {
+                throw std::runtime_error("malformed level, run length must be positive");
+            }
+        }
+
+        element = content[i++];
+        if (!get_tile_traits(element).is_level_element) {
+            throw std::runtime_error("malformed level, unknown level element");
+        }
+        return count;
+    }
+
+    constexpr char next() {
+        if (remaining == 0) {
+            if (i >= end) return AIR;
+            remaining = readRun();
+        }
+        --remaining;
+        return element;
+    }
+};
+
+// Calls `visitor(content)` for every level of the pack, skipping comments and empty lines
+template <typename Visitor>
+constexpr void for_each_embedded_level(std::string_view pack, Visitor&& visitor) {
+    for (size_t lineStart = 0; lineStart < pack.length();) {
+        // Not string_view::find(), which some standard libraries implement with builtins that are not constexpr
+        size_t lineEnd = lineStart;
+        while (lineEnd < pack.length() && pack[lineEnd] != '\n') {
+            ++lineEnd;
+        }
+        std::string_view line = pack.substr(lineStart, lineEnd - lineStart);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        lineStart = lineEnd + 1;
+
+        if (!line.empty() && line[0] != ';') {
+            visitor(line);
+        }
+    }
+}
+
+// Calls `visitor(begin, end)` for every row of a level; rows are separated by pipes, and a period ends the level
+template <typename Visitor>
+constexpr void for_each_embedded_row(std::string_view content, Visitor&& visitor) {
+    size_t begin = 0;
+    for (size_t i = 0; i < content.length(); ++i) {
+        if (content[i] == '|' || content[i] == '.') {
+            bool terminated = content[i] == '.';
+            if (!terminated || i > begin) {
+                visitor(begin, i);
+            }
+            if (terminated) return;
+            begin = i + 1;
+        }
+    }
+    if (content.length() > begin) {
+        visitor(begin, content.length());
+    }
+}
+
+// Everything about a level but its cells: its size, entities, and spawn point. The entities are written to the pack,
+// if there is one, after the ones of the levels before it, whose counts `first` starts from.
+template <typename Pack>
+constexpr embedded_level_info scan_embedded_level(std::string_view content, Pack* pack, const embedded_level_info& first) {
+    embedded_level_info info = first;
+    for_each_embedded_row(content, [&](size_t begin, size_t end) {
+        embedded_run_cursor cursor = {content, begin, end};
+        size_t column = 0;
+        while (cursor.i < cursor.end) {
+            size_t count = cursor.readRun();
+            for (size_t j = 0; j < count; ++j) {
+                level_position position = {info.rows, column + j};
+                switch (cursor.element) {
+                    case PLAYER:
+                        if (!info.has_spawn_point) {
+                            info.has_spawn_point = true;
+                            info.spawn_point = position;
+                        }
+                        break;
+                    case ENEMY:
+                    case CHASER:
+                        if (pack) pack->enemies[info.first_enemy + info.enemy_count] = position;
+                        ++info.enemy_count;
+                        break;
+                    case COIN:
+                        if (pack) pack->coins[info.first_coin + info.coin_count] = position;
+                        ++info.coin_count;
+                        break;
+                    case EXIT:
+                        if (pack) pack->exits[info.first_exit + info.exit_count] = position;
+                        ++info.exit_count;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            column += count;
+        }
+        info.columns = std::max(info.columns, column);
+        ++info.rows;
+    });
+    return info;
+}
+
+// Calls `visitor(chunk)` for every chunk of a level that is not all air, reading every row only once
+template <typename Visitor>
+constexpr void for_each_embedded_chunk(std::string_view content, const embedded_level_info& info, Visitor&& visitor) {
+    size_t chunkColumns = (info.columns + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+
+    embedded_run_cursor cursors[LEVEL_CHUNK_SIZE] = {};
+    size_t row = 0;
+    for_each_embedded_row(content, [&](size_t begin, size_t end) {
+        cursors[row % LEVEL_CHUNK_SIZE] = {content, begin, end};
+        ++row;
+
+        // Once a band of chunk rows is complete, its chunks are read left to right
+        if (row % LEVEL_CHUNK_SIZE != 0 && row != info.rows) return;
+        size_t chunkRow = (row - 1) / LEVEL_CHUNK_SIZE;
+        size_t bandRows = row - chunkRow * LEVEL_CHUNK_SIZE;
+        for (size_t chunkColumn = 0; chunkColumn < chunkColumns; ++chunkColumn) {
+            embedded_chunk chunk;
+            chunk.index = chunkRow * chunkColumns + chunkColumn;
+            bool isEmpty = true;
+            for (size_t r = 0; r < LEVEL_CHUNK_SIZE; ++r) {
+                for (size_t c = 0; c < LEVEL_CHUNK_SIZE; ++c) {
+                    char cell = r < bandRows ? cursors[r].next() : AIR;
+                    chunk.cells[r * LEVEL_CHUNK_SIZE + c] = cell;
+                    isEmpty = isEmpty && cell == AIR;
+                }
+            }
+            if (!isEmpty) {
+                visitor(chunk);
+            }
+        }
+    });
+}
+
+constexpr embedded_pack_size measure_embedded_level_pack(std::string_view pack) {
+    embedded_pack_size size;
+    for_each_embedded_level(pack, [&](std::string_view content) {
+        embedded_level_pack<0, 0, 0, 0, 0>* none = nullptr;
+        embedded_level_info info = scan_embedded_level(content, none, {});
+        for_each_embedded_chunk(content, info, [&](const embedded_chunk&) { ++size.chunks; });
+        ++size.levels;
+        size.enemies += info.enemy_count;
+        size.coins += info.coin_count;
+        size.exits += info.exit_count;
+    });
+    return size;
+}
+
+template <size_t LEVELS, size_t CHUNKS, size_t ENEMIES, size_t COINS, size_t EXITS>
+constexpr embedded_level_pack<LEVELS, CHUNKS, ENEMIES, COINS, EXITS> decode_embedded_level_pack(std::string_view pack) {
+    embedded_level_pack<LEVELS, CHUNKS, ENEMIES, COINS, EXITS> result = {};
+    embedded_level_info next;
+    for_each_embedded_level(pack, [&](std::string_view content) {
+        embedded_level_info info = scan_embedded_level(content, &result, next);
+
+        for_each_embedded_chunk(content, info, [&](const embedded_chunk& chunk) {
+            result.chunks[info.first_chunk + info.chunk_count] = chunk;
+            ++info.chunk_count;
+        });
+        result.levels[result.level_count++] = info;
+
+        next = {};
+        next.first_chunk = info.first_chunk + info.chunk_count;
+        next.first_enemy = info.first_enemy + info.enemy_count;
+        next.first_coin = info.first_coin + info.coin_count;
+        next.first_exit = info.first_exit + info.exit_count;
+    });
+    return result;
+}
+
+#ifdef EMBED_LEVELS
+
+// Generated by CMake from embedded_level_pack.h.in, holds the level pack as EMBEDDED_LEVEL_PACK
+#include "embedded_level_pack.h"
+
+inline constexpr std::string_view EMBEDDED_LEVEL_PACK_CONTENT(EMBEDDED_LEVEL_PACK, sizeof(EMBEDDED_LEVEL_PACK) - 1);
+inline constexpr embedded_pack_size EMBEDDED_PACK_SIZE = measure_embedded_level_pack(EMBEDDED_LEVEL_PACK_CONTENT);
+inline constexpr auto EMBEDDED_LEVELS = decode_embedded_level_pack<
+    EMBEDDED_PACK_SIZE.levels, EMBEDDED_PACK_SIZE.chunks,
+    EMBEDDED_PACK_SIZE.enemies, EMBEDDED_PACK_SIZE.coins, EMBEDDED_PACK_SIZE.exits
+>(EMBEDDED_LEVEL_PACK_CONTENT);
+
+#endif // EMBED_LEVELS
+
+#endif // EMBEDDED_LEVELS_H
@@ -1,95 +1,100 @@
 #include "enemy.h"
 #include "level.h"
+#include "player.h"
 #include "globals.h"  // Still needed for ENEMY_MOVEMENT_SPEED, WALL, etc.
+#include <algorithm>
 
 // This is enemy.cpp
 // Initialize static member
-std::vector<Enemy> Enemy::all_enemies;
+FlowField Enemy::chase_field;
+bool Enemy::has_chasers = false;
 
-Enemy::Enemy(Vector2 position, bool isLookingRight)
-    : pos(position), is_looking_right(isLookingRight) {
+Enemy::Enemy(entity_id enemyEntity)
+    : entity(enemyEntity) {
     // Constructor
 }
 
-void Enemy::update() {
-    // Find the enemy's next x
-    float next_x = pos.x;
-    next_x += (is_looking_right ? ENEMY_MOVEMENT_SPEED : -ENEMY_MOVEMENT_SPEED);
-
-    // If its next position collides with a wall, turn around
-    if (Level::getInstance()->isColliding({next_x, pos.y}, WALL)) {
-        is_looking_right = !is_looking_right;
-    }
-    // Otherwise, keep moving
-    else {
-        pos.x = next_x;
-    }
-}
-
 Vector2 Enemy::getPosition() const {
-    return pos;
+    return World::getInstance()->getPosition(entity);
 }
 
-bool Enemy::isLookingRight() const {
-    return is_looking_right;
+entity_id Enemy::getEntity() const {
+    return entity;
 }
 
 // Static methods for enemy management
 void Enemy::spawnAll() {
     Level* levelPtr = Level::getInstance();
-    const struct level& currentLevel = levelPtr->getCurrentLevel();
-
-    // Create enemies, incrementing their amount every time a new one is created
-    all_enemies.clear();
-
-    for (size_t row = 0; row < currentLevel.rows; ++row) {
-        for (size_t column = 0; column < currentLevel.columns; ++column) {
-            char cell = levelPtr->getLevelCell(row, column);
-
-            if (cell == ENEMY) {
-                // Create enemy object and add to enemies vector
-                all_enemies.push_back(Enemy({static_cast<float>(column), static_cast<float>(row)}, true));
-                levelPtr->setLevelCell(row, column, AIR);
-            }
+    World* world = World::getInstance();
+    array_view<const level_position> enemySpawns = levelPtr->getEnemySpawns();
+
+    // Create an enemy for every spawn point found while decoding the level
+    world->destroyAll(ENEMY_COMPONENT);
+    has_chasers = false;
+
+    for (const auto &spawn : enemySpawns) {
+        // The spawn marker tells which kind of enemy goes there
+        bool isChaser = levelPtr->getLevelCell(spawn.row, spawn.column) == CHASER;
+        has_chasers = has_chasers || isChaser;
+
+        uint32_t components = ENEMY_COMPONENT | POSITION_COMPONENT | PATROL_COMPONENT | ANIMATION_COMPONENT;
+        entity_id enemy = world->create(isChaser ? components | CHASE_COMPONENT : components);
+        world->getPosition(enemy) = {static_cast<float>(spawn.column), static_cast<float>(spawn.row)};
+        world->getPatrol(enemy) = {true, ENEMY_MOVEMENT_SPEED};
+        updatePatrolSpan(world->getPosition(enemy), world->getPatrol(enemy));
+        world->getAnimation(enemy).source = &enemy_walk;
+        if (isChaser) {
+            world->getChase(enemy).speed = CHASER_MOVEMENT_SPEED;
         }
+
+        levelPtr->setLevelCell(spawn.row, spawn.column, AIR);
     }
-}
 
-void Enemy::updateAll() {
-    for (auto &enemy : all_enemies) {
-        enemy.update();
+    // Only levels with chasers pay for the field
+    const level& currentLevel = levelPtr->getCurrentLevel();
+    if (has_chasers) {
+        chase_field.resize(currentLevel.rows, currentLevel.columns);
+    }
+    else {
+        chase_field.resize(0, 0);
     }
 }
 
-bool Enemy::isCollidingWith(Vector2 pos) {
-    Rectangle entityHitbox = {pos.x, pos.y, 1.0f, 1.0f};
+void Enemy::updateChaseField() {
+    // Done before the systems run, so that the chasers only ever read the field
+    if (!has_chasers) return;
 
-    for (auto &enemy : all_enemies) {
-        Rectangle enemyHitbox = {enemy.pos.x, enemy.pos.y, 1.0f, 1.0f};
-        if (CheckCollisionRecs(entityHitbox, enemyHitbox)) {
-            return true;
-        }
-    }
-    return false;
+    Vector2 playerPos = Player::getInstance()->getPosition();
+    chase_field.update({
+        static_cast<size_t>(std::max(0.0f, roundf(playerPos.y))),
+        static_cast<size_t>(std::max(0.0f, roundf(playerPos.x)))
+    });
 }
 
-void Enemy::removeColliding(Vector2 pos) {
-    Rectangle entityHitbox = {pos.x, pos.y, 1.0f, 1.0f};
-
-    for (auto it = all_enemies.begin(); it != all_enemies.end(); it++) {
-        Rectangle enemyHitbox = {it->pos.x, it->pos.y, 1.0f, 1.0f};
-        // Erase a colliding enemy
-        if (CheckCollisionRecs(entityHitbox, enemyHitbox)) {
-            all_enemies.erase(it);
+void Enemy::updatePatrolSpan(Vector2 pos, patrol_component &patrol) {
+    horizontal_span span = Level::getInstance()->findHorizontalSpan<SOLID_TILE>(pos);
+    patrol.has_span = true;
+    patrol.span_y = pos.y;
+    patrol.span_left = span.left;
+    patrol.span_right = span.right;
+}
 
-            // Call the function again to remove any remaining colliding enemies
-            // Cannot continue as calling erase on a vector invalidates current iterators
-            removeColliding(pos);
-            return;
+void Enemy::invalidatePatrolSpans(size_t row) {
+    // Only the enemies whose hitbox spans the row can have a wall there
+    World::getInstance()->forEach(POSITION_COMPONENT | PATROL_COMPONENT, [row](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            float y = group.patrols[i].span_y;
+            if (floorf(y) <= row && ceilf(y) >= row) {
+                group.patrols[i].has_span = false;
+            }
         }
-    }
+    });
 }
 
-const std::vector<Enemy>& Enemy::getAllEnemies() {
-    return all_enemies;
-}
\ No newline at end of file
+void Enemy::invalidateChaseField() {
+    chase_field.invalidate();
+}
+
+const FlowField& Enemy::getChaseField() {
+    return chase_field;
+}
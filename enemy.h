@@ -3,35 +3,33 @@
 
 // This is enemy.h
 #include "raylib.h"
-#include <vector>
+#include "flow_field.h"
+#include "world.h"
 
+// A handle to an enemy entity in the world; the enemies are moved by the patrol and chase systems
 class Enemy {
 private:
-    Vector2 pos;
-    bool is_looking_right;
+    entity_id entity;
 
-    // Static collection of all enemies
-    static std::vector<Enemy> all_enemies;
+    // Shared by all the chasers, and only searched again when the player moves to another cell
+    static FlowField chase_field;
+    static bool has_chasers;
 
 public:
     // Constructor
-    Enemy(Vector2 position, bool isLookingRight = true);
-
-    // Enemy methods
-    void update();
+    explicit Enemy(entity_id enemyEntity);
 
     // Getters
     Vector2 getPosition() const;
-    bool isLookingRight() const;
+    entity_id getEntity() const;
 
     // Static methods for enemy management
     static void spawnAll();
-    static void updateAll();
-    static bool isCollidingWith(Vector2 pos);
-    static void removeColliding(Vector2 pos);
-
-    // Get all enemies (for rendering, etc.)
-    static const std::vector<Enemy>& getAllEnemies();
+    static void updateChaseField();
+    static void invalidateChaseField();
+    static void updatePatrolSpan(Vector2 pos, patrol_component &patrol);
+    static void invalidatePatrolSpans(size_t row);
+    static const FlowField& getChaseField();
 };
 
-#endif // ENEMY_H
\ No newline at end of file
+#endif // ENEMY_H
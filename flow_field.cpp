@@ -0,0 +1,163 @@
+#include "flow_field.h"
+#include "globals.h"
+#include <algorithm>
+
+// This is flow_field.cpp
+
+FlowField::FlowField() :
+    rows(0),
+    columns(0),
+    window_row(0),
+    window_column(0),
+    generation(0),
+    search_count(0),
+    has_target(false),
+    target()
+{
+    // Sized by resize() once a level is loaded
+}
+
+void FlowField::resize(size_t newRows, size_t newColumns) {
+    rows = newRows;
+    columns = newColumns;
+    generation = 0;
+    has_target = false;
+
+    // Swapping with empty vectors is the only way to be sure their memory is given back
+    if (rows == 0 || columns == 0) {
+        std::vector<uint16_t>().swap(distances);
+        std::vector<uint32_t>().swap(stamps);
+        std::vector<uint32_t>().swap(frontier);
+        return;
+    }
+
+    // The window is the same size for every level, so it is only allocated by the first level with chasers
+    const size_t WINDOW_CELLS = static_cast<size_t>(FLOW_FIELD_SIDE) * FLOW_FIELD_SIDE;
+    distances.resize(WINDOW_CELLS);
+    stamps.assign(WINDOW_CELLS, 0);
+    frontier.resize(WINDOW_CELLS);
+}
+
+void FlowField::invalidate() {
+    has_target = false;
+}
+
+bool FlowField::isOpen(long row, long column) const {
+    if (row < 0 || row >= static_cast<long>(rows) || column < 0 || column >= static_cast<long>(columns)) {
+        return false;
+    }
+    return !has_tile_traits(Level::getInstance()->getLevelCell(row, column), SOLID_TILE);
+}
+
+bool FlowField::getWindowIndex(long row, long column, size_t& index) const {
+    long windowRow = row - window_row;
+    long windowColumn = column - window_column;
+    if (windowRow < 0 || windowRow >= FLOW_FIELD_SIDE || windowColumn < 0 || windowColumn >= FLOW_FIELD_SIDE) {
+        return false;
+    }
+    index = static_cast<size_t>(windowRow * FLOW_FIELD_SIDE + windowColumn);
+    return true;
+}
+
+bool FlowField::update(level_position newTarget) {
+    if (has_target && newTarget.row == target.row && newTarget.column == target.column) {
+        return false;
+    }
+    has_target = true;
+    target = newTarget;
+    ++search_count;
+
+    // Starting a new generation makes every distance from the last search stale at once
+    if (++generation == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+
+    if (!isOpen(target.row, target.column)) {
+        return true;
+    }
+
+    // Every cell within FLOW_FIELD_RADIUS steps of the target is inside the window
+    window_row = static_cast<long>(target.row) - FLOW_FIELD_RADIUS;
+    window_column = static_cast<long>(target.column) - FLOW_FIELD_RADIUS;
+
+    size_t head = 0, tail = 0;
+    size_t start = 0;
+    getWindowIndex(target.row, target.column, start);
+    stamps[start] = generation;
+    distances[start] = 0;
+    frontier[tail++] = static_cast<uint32_t>(start);
+
+    const long ROW_STEPS[]    = { -1, 1,  0, 0 };
+    const long COLUMN_STEPS[] = {  0, 0, -1, 1 };
+
+    while (head < tail) {
+        size_t cell = frontier[head++];
+        uint16_t distance = distances[cell];
+
+        // Enemies further away than the radius just keep patrolling, so there is no need to look further
+        if (distance >= FLOW_FIELD_RADIUS) continue;
+
+        long row = window_row + static_cast<long>(cell / FLOW_FIELD_SIDE);
+        long column = window_column + static_cast<long>(cell % FLOW_FIELD_SIDE);
+        for (size_t i = 0; i < 4; ++i) {
+            long nextRow = row + ROW_STEPS[i];
+            long nextColumn = column + COLUMN_STEPS[i];
+            if (!isOpen(nextRow, nextColumn)) continue;
+
+            // Cells closer than the radius are never on the window's edge, so their neighbours are inside it
+            size_t next = 0;
+            getWindowIndex(nextRow, nextColumn, next);
+            if (stamps[next] == generation) continue;
+
+            stamps[next] = generation;
+            distances[next] = distance + 1;
+            frontier[tail++] = static_cast<uint32_t>(next);
+        }
+    }
+
+    return true;
+}
+
+bool FlowField::isReachable(size_t row, size_t column) const {
+    size_t index = 0;
+    return has_target && row < rows && column < columns &&
+           getWindowIndex(static_cast<long>(row), static_cast<long>(column), index) && stamps[index] == generation;
+}
+
+uint16_t FlowField::getDistance(size_t row, size_t column) const {
+    // Only meaningful for reachable cells, which are inside the window
+    size_t index = 0;
+    getWindowIndex(static_cast<long>(row), static_cast<long>(column), index);
+    return distances[index];
+}
+
+bool FlowField::getNextCell(level_position from, level_position& next) const {
+    if (!isReachable(from.row, from.column)) {
+        return false;
+    }
+
+    next = from;
+    uint16_t best = getDistance(from.row, from.column);
+    const level_position neighbours[] = {
+        { from.row - 1, from.column }, { from.row + 1, from.column },
+        { from.row, from.column - 1 }, { from.row, from.column + 1 }
+    };
+    for (const auto &neighbour : neighbours) {
+        // Wrapped-around positions from row or column 0 are out of range and not reachable
+        if (isReachable(neighbour.row, neighbour.column) && getDistance(neighbour.row, neighbour.column) < best) {
+            best = getDistance(neighbour.row, neighbour.column);
+            next = neighbour;
+        }
+    }
+    return true;
+}
+
+size_t FlowField::getSearchCount() const {
+    return search_count;
+}
+
+size_t FlowField::getStorageBytes() const {
+    return distances.capacity() * sizeof(uint16_t) + stamps.capacity() * sizeof(uint32_t) +
+           frontier.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,59 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+// This is flow_field.h
+#include "level.h"
+#include <cstdint>
+#include <vector>
+
+// A map of how many steps every open cell around a target is from it, found by a breadth-first search.
+// Any number of agents can head toward the target by stepping to their neighbour closest to it, so the
+// search is done once per target cell instead of once per agent.
+// The search never goes further than FLOW_FIELD_RADIUS steps, so the field only covers a square window of
+// FLOW_FIELD_SIDE x FLOW_FIELD_SIDE cells centered on the target, however large the level is.
+class FlowField {
+    size_t rows;
+    size_t columns;
+
+    // The level cell at the window's top left corner; it may be outside the level
+    long window_row;
+    long window_column;
+
+    // A cell's distance is only valid if its stamp matches the current generation,
+    // so nothing has to be cleared between two searches
+    std::vector<uint16_t> distances;
+    std::vector<uint32_t> stamps;
+    uint32_t generation;
+
+    std::vector<uint32_t> frontier;
+    size_t search_count;
+
+    bool has_target;
+    level_position target;
+
+    bool isOpen(long row, long column) const;
+    bool getWindowIndex(long row, long column, size_t& index) const;
+
+public:
+    FlowField();
+
+    // Sets the level's size for a new level; the field is empty until the next update.
+    // A size of 0 x 0 releases the field's memory, for levels without chasers.
+    void resize(size_t rows, size_t columns);
+    void invalidate();
+
+    // Searches again from the target, but only if it moved to another cell since the last search.
+    // Returns whether it did.
+    bool update(level_position newTarget);
+
+    bool isReachable(size_t row, size_t column) const;
+    uint16_t getDistance(size_t row, size_t column) const;
+
+    // The neighbour of `from` that is one step closer to the target, if `from` is within the field's reach
+    bool getNextCell(level_position from, level_position& next) const;
+
+    size_t getSearchCount() const;
+    size_t getStorageBytes() const;
+};
+
+#endif // FLOW_FIELD_H
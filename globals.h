@@ -4,21 +4,60 @@
 // This is globals.h
 #include "raylib.h"
 
+#include "spsc_queue.h"
+#include "arena.h"
+#include "tiles.h"
+#include "world.h"
+#include "scheduler.h"
+
 #include <vector>
 #include <string>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <csignal>
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/* Launch Options */
+
+struct game_options {
+    bool trace_latency = false; // Measure how long it takes for an input to show up on screen
+    bool late_input = false;    // Poll the input and run the tick as late in the frame as possible
+    bool vsync = true;
+    bool alloc_test = false;    // Run a scripted session and fail if a gameplay frame allocates
+    bool low_res_scene = false; // Draw the scene at a low resolution and scale it up to the window
+    bool pipelined = false;     // Run the next tick on a worker thread while the last one is drawn
+    bool poll_input = false;    // Poll the keyboard every millisecond between frames, and replay the key edges in ticks
+    bool fixed_quality = false; // Keep the full quality instead of lowering it when frames take too long
+
+    // Capture every frame, either as a PNG sequence in a directory, or as raw RGBA piped to an encoder's command
+    const char *capture_directory = nullptr;
+    const char *capture_command = nullptr;
+};
+
+inline game_options launch_options;
 
 /* Game Elements */
 
-inline const char WALL      = '#',
-                  WALL_DARK = '=',
-                  AIR       = '-',
-                  SPIKE     = '^',
-                  PLAYER    = '@',
-                  ENEMY     = '&',
-                  COIN      = '*',
-                  EXIT      = 'E';
+// Tile characters and their traits are in tiles.h
+
+/* Level decoding */
+
+inline const char  *LEVEL_PACK_FILE           = "data/levels.rll";
+inline const size_t MAX_RUN_LENGTH            = 1 << 30;
+inline const size_t PARALLEL_DECODE_MIN_CELLS = 1 << 20; // Smaller levels decode faster on a single thread
+inline const size_t LEVEL_ARENA_BLOCK_SIZE    = 64 * 1024;
+inline const size_t LEVEL_CHUNK_SIZE          = 16;      // Level grids are stored in square chunks this many cells wide
+
+/* Frame Scratch Memory */
+
+// Temporaries that only have to live until the end of the frame, e.g., the HUD strings; reset every tick
+inline const size_t FRAME_ARENA_BLOCK_SIZE = 16 * 1024;
+inline Arena frame_arena("frame", FRAME_ARENA_BLOCK_SIZE);
 
 /* Timer-mechanic related */
 inline const int MAX_LEVEL_TIME = 50 * 60;
@@ -33,6 +72,20 @@ inline const float CEILING_BOUNCE_OFF    = 0.05f;
 inline const float ENEMY_MOVEMENT_SPEED  = 0.07f;
 inline const float BOUNCE_OFF_ENEMY      = 0.1f;
 inline const float GRAVITY_FORCE         = 0.01f;
+inline const float CHASER_MOVEMENT_SPEED = 0.05f;
+inline const uint16_t FLOW_FIELD_RADIUS  = 48; // Chasers further away from the player than this keep patrolling
+inline const long FLOW_FIELD_SIDE        = 2 * FLOW_FIELD_RADIUS + 1;
+
+/* Entity Systems */
+
+inline SystemScheduler system_scheduler;
+inline const size_t SYSTEM_WORKER_COUNT = 3;
+inline const size_t PARALLEL_SYSTEMS_MIN_ENTITIES = 4096; // Fewer entities are updated faster on a single thread
+
+// What the contact system found the player touching during the last tick
+inline const size_t MAX_PLAYER_CONTACTS = 16;
+inline entity_id player_contacts[MAX_PLAYER_CONTACTS];
+inline size_t player_contact_count = 0;
 
 /* Graphic Metrics */
 
@@ -44,17 +97,49 @@ inline float screen_scale; // Used to scale str/UI components size and displacem
 inline float cell_size;
 inline float horizontal_shift;
 
+// The scene (the background, the tiles and the entities) is drawn either straight to the window,
+// or to a low-resolution target that is scaled up to the window by a whole factor; the HUD is always native
+inline const float LOW_RES_SCENE_HEIGHT = 480.0f;
+inline Vector2 scene_size;
+inline int scene_scale = 1;
+inline RenderTexture2D scene_target;
+
 // Parallax background scrolling
 inline Vector2 background_size;
 inline float background_y_offset;
 
 inline const float PARALLAX_PLAYER_SCROLLING_SPEED = 0.003f;
 inline const float PARALLAX_IDLE_SCROLLING_SPEED = 0.00005f;
-inline const float PARALLAX_LAYERED_SPEED_DIFFERENCE = 3.0f;
+
+/* HUD */
+
+inline const float HUD_ICON_SIZE = 48.0f; // Scaled by screen_scale
 
 /* Fonts */
 
+// Glyphs are stored as signed distance fields at a small size, and the shader keeps their edges sharp at any size
+inline const int SDF_FONT_BASE_SIZE = 32;
+inline const int SDF_FONT_GLYPH_COUNT = 95;  // Printable ASCII, from ' ' to '~'
+inline const int SDF_FONT_CACHE_VERSION = 1;
+
+struct sdf_font_cache_header {
+    char magic[4];
+    int version;
+    long source_mod_time;
+    int base_size;
+    int glyph_count;
+    int atlas_width, atlas_height, atlas_format;
+};
+
+struct sdf_font_cache_glyph {
+    int value;
+    int offset_x, offset_y;
+    int advance_x;
+    Rectangle rectangle;
+};
+
 inline Font menu_font;
+inline Shader sdf_font_shader;
 
 /* Display Text Parameters */
 
@@ -121,13 +206,12 @@ inline Text victory_subtitle = {
 
 /* Images and Sprites */
 
+// Sprites hold no playback state; the current frame is derived from the shared animation clock,
+// so drawing a sprite any number of times per frame never changes how fast it animates.
 struct sprite {
     size_t frame_count    = 0;
     size_t frames_to_skip = 3;
-    size_t frames_skipped = 0;
-    size_t frame_index    = 0;
     bool loop = true;
-    size_t prev_game_frame = 0;
     Texture2D *frames = nullptr;
 };
 
@@ -154,9 +238,69 @@ inline sprite player_walk_backwards_sprite;
 inline sprite enemy_walk;
 
 // Background Elements
-inline Texture2D background;
-inline Texture2D middleground;
-inline Texture2D foreground;
+struct parallax_layer {
+    Texture2D texture = {};
+    float speed = 0.0f; // Multiplies the scrolling, 0 keeps the layer still
+};
+
+// Listed from the back to the front in PARALLAX_LAYERS_FILE; every layer wraps around, so each is a single quad
+inline const char *PARALLAX_LAYERS_FILE = "data/images/background/layers.txt";
+inline std::vector<parallax_layer> background_layers;
+
+// The still layers at the back never change on screen, so they are drawn into one texture once per resize
+inline RenderTexture2D composed_background_target;
+inline size_t composed_background_layers = 0;
+
+/* Static Tile Cache */
+
+// Walls, dark walls, and spikes never move, so they are baked into render textures, each covering
+// a band of STATIC_TILE_CHUNK_COLUMNS columns, and drawn as a single quad per visible band.
+struct static_tile_chunk {
+    RenderTexture2D target = {};
+    bool is_dirty = true;
+};
+
+inline const size_t STATIC_TILE_CHUNK_COLUMNS = 16;
+inline std::vector<static_tile_chunk> static_tile_chunks;
+inline float static_tile_chunks_cell_size = 0.0f; // The cell size the chunks were baked at
+
+/* Draw List */
+
+// Everything drawn during gameplay is submitted to a per-frame draw list, which is then sorted by layer and texture
+// and drawn in one pass, so that quads sharing a texture end up in the same batch.
+enum draw_layer {
+    PARALLAX_LAYER,
+    TILE_LAYER,
+    ITEM_LAYER,
+    ENTITY_LAYER,
+    HUD_LAYER
+};
+
+struct draw_command {
+    draw_layer layer = TILE_LAYER;
+    size_t depth = 0; // Orders the commands of a layer before their texture does, e.g., the parallax layers
+    Texture2D texture = {};
+    Rectangle source = {};
+    Rectangle destination = {};
+    Color tint = WHITE;
+
+    // Text commands draw `text` with `font` at the destination's position, using its height as the font size
+    const Font *font = nullptr;
+    float spacing = 0.0f;
+    char text[16] = {};
+
+    size_t order = 0; // Submission order, keeps the sort stable
+};
+
+struct draw_stats {
+    size_t draw_calls = 0; // Quads and strings drawn
+    size_t batches = 0;    // Texture switches, i.e., the batches raylib had to flush
+};
+
+inline const size_t DRAW_LIST_INITIAL_CAPACITY = 1024;
+inline std::vector<draw_command> draw_list;
+inline draw_stats frame_draw_stats;
+inline bool show_stats_overlay = false;
 
 /* Sounds */
 
@@ -166,6 +310,44 @@ inline Sound player_death_sound;
 inline Sound kill_enemy_sound;
 inline Sound game_over_sound;
 
+// Gameplay never plays sounds directly. It queues sound events, which the mixer thread plays
+// on a small pool of voices (aliases of the loaded sound) per sound.
+enum sound_id {
+    COIN_SOUND,
+    EXIT_SOUND,
+    KILL_ENEMY_SOUND,
+    PLAYER_DEATH_SOUND,
+    GAME_OVER_SOUND,
+    SOUND_COUNT
+};
+
+struct sound_event {
+    sound_id id = COIN_SOUND;
+    size_t tick = 0;
+};
+
+inline const size_t MAX_VOICES_PER_SOUND = 4;
+inline const size_t MAX_ACTIVE_VOICES    = 6;
+inline const size_t SOUND_QUEUE_CAPACITY = 64;
+inline const int SOUND_MIXER_POLL_INTERVAL_MS = 2;
+
+struct sound_voice_pool {
+    size_t voice_count = 1;
+    int priority = 0;             // A sound may steal voices from sounds of the same or lower priority
+    size_t min_ticks_between = 1; // Events of this sound closer together than this are coalesced
+    Sound voices[MAX_VOICES_PER_SOUND] = {};
+    size_t voice_started_at[MAX_VOICES_PER_SOUND] = {};
+    size_t last_played_tick = 0;
+    bool has_played = false;
+};
+
+inline sound_voice_pool sound_pools[SOUND_COUNT];
+inline size_t sound_voice_sequence = 0; // Orders voices by when they were started, only used by the mixer
+inline SpscQueue<sound_event, SOUND_QUEUE_CAPACITY> sound_queue;
+inline std::thread sound_mixer_thread;
+inline std::atomic<bool> is_sound_mixer_running{false};
+inline std::atomic<size_t> dropped_sound_events{0};
+
 /* Victory Menu Background */
 
 struct victory_ball {
@@ -182,10 +364,183 @@ inline const Color VICTORY_BALL_COLOR      = { 180, 180, 180, 255 };
 inline const unsigned char VICTORY_BALL_TRAIL_TRANSPARENCY = 10;
 inline victory_ball victory_balls[VICTORY_BALL_COUNT];
 
+/* Input */
+
+enum game_action {
+    MOVE_RIGHT_ACTION,
+    MOVE_LEFT_ACTION,
+    JUMP_ACTION,
+    CONFIRM_ACTION,
+    PAUSE_ACTION,
+    TOGGLE_STATS_ACTION,
+    ACTION_COUNT
+};
+
+struct input_state {
+    bool is_down[ACTION_COUNT] = {};
+    bool was_pressed[ACTION_COUNT] = {}; // Latched until a tick consumes it
+    double pressed_at[ACTION_COUNT] = {};
+    float held_for[ACTION_COUNT] = {};   // The part of the tick's time span during which the action was down
+};
+
+inline input_state current_input; // Sampled from the keyboard
+inline input_state tick_input;    // Handed over to the tick about to run, the only input the simulation reads
+
+// A change of an action's state seen by the input polling, with the time it was seen at
+struct input_event {
+    game_action action = MOVE_RIGHT_ACTION;
+    bool is_down = false;
+    double time = 0.0;
+};
+
+inline const int TARGET_FRAME_RATE = 60;
+inline const double INPUT_POLL_INTERVAL = 0.001;
+inline const size_t INPUT_EVENT_QUEUE_CAPACITY = 256;
+
+// Pushed to by the main thread, which polls the keyboard, and popped by whichever thread runs the ticks
+inline SpscQueue<input_event, INPUT_EVENT_QUEUE_CAPACITY> input_events;
+inline bool polled_input_down[ACTION_COUNT] = {};        // Only used by the main thread
+inline input_event carried_input_event;                  // An event popped by a tick that belongs to the next one
+inline bool has_carried_input_event = false;
+inline double tick_input_from = 0.0, tick_input_until = 0.0; // The time span the tick about to run replays
+inline double next_polled_frame_at = 0.0;
+
+/* Latency Tracing */
+
+struct latency_sample {
+    double pressed_at = 0.0;
+    double consumed_at = 0.0;
+    size_t tick = 0;
+};
+
+struct latency_summary {
+    size_t samples = 0;
+    float p50_ms = 0.0f, p90_ms = 0.0f, p99_ms = 0.0f, max_ms = 0.0f;
+    float mean_input_to_tick_ms = 0.0f;
+};
+
+inline const size_t MAX_PENDING_LATENCY_SAMPLES = ACTION_COUNT;
+inline const size_t LATENCY_SAMPLE_CAPACITY     = 4096;
+inline const double LATE_INPUT_SAFETY_MARGIN    = 0.002; // Seconds left between the late tick and the present
+
+inline latency_sample pending_latency_samples[MAX_PENDING_LATENCY_SAMPLES];
+inline size_t pending_latency_count = 0;
+inline float input_to_tick_ms[LATENCY_SAMPLE_CAPACITY];
+inline float input_to_present_ms[LATENCY_SAMPLE_CAPACITY];
+inline size_t latency_sample_count = 0;
+inline latency_summary latency_stats;
+
+// Frame pacing
+inline double frame_work_started_at = 0.0;
+inline double submit_started_at = 0.0;
+inline double frame_work_estimate = 0.0;
+inline double last_present_time = 0.0;
+
 /* Frame Counter */
 
 inline size_t game_frame = 0;
 
+/* Animation Clock */
+
+inline size_t animation_ticks = 0;       // Advanced once per game tick
+inline size_t animation_clock = 0;       // Follows animation_ticks in steps of the quality's animation interval, read by every sprite
+inline size_t last_animated_clock = SIZE_MAX;
+
+/* Memory Accounting */
+
+// Every subsystem reports the memory it holds when asked. The CPU bytes are what it reserved, and the GPU bytes are
+// estimated from the size, format, and mipmaps of its textures, as the driver may pad or compress them.
+struct memory_usage {
+    size_t cpu_bytes = 0;
+    size_t gpu_bytes = 0;
+};
+
+struct memory_account {
+    const char *name = "";
+    memory_usage (*measure)() = nullptr;
+    memory_usage current;
+    memory_usage level_high_water; // Since the current level was loaded
+    memory_usage high_water;       // Since the game started
+};
+
+inline const size_t MAX_MEMORY_ACCOUNTS = 16;
+inline memory_account memory_accounts[MAX_MEMORY_ACCOUNTS];
+inline size_t memory_account_count = 0;
+inline memory_usage memory_total;
+inline size_t memory_accounted_level_load = 0;
+inline int memory_accounted_level_index = 0;
+
+// Kept up to date by the asset loaders as they load and unload, rather than measured from the assets
+inline memory_usage loaded_image_memory;
+inline memory_usage loaded_font_memory;
+inline memory_usage loaded_sound_memory;
+
+/* Frame Capture */
+
+// Frames are read back by the main thread, but encoding and writing them is left to a pool of workers, which take
+// them from a ring of CAPTURE_RING_SIZE frames; when the workers fall behind, frames are dropped instead of the game
+// waiting for them. A raw stream has to stay in order, so it is written by a single worker.
+struct captured_frame {
+    Image image = {};
+    size_t index = 0;
+};
+
+inline const size_t CAPTURE_RING_SIZE    = 8;
+inline const size_t CAPTURE_WORKER_COUNT = 3;
+
+inline captured_frame capture_ring[CAPTURE_RING_SIZE];
+inline size_t capture_ring_first = 0;  // The oldest frame waiting for a worker
+inline size_t capture_ring_count = 0;
+inline std::mutex capture_mutex;
+inline std::condition_variable capture_frame_queued;
+inline bool is_capture_running = false;
+inline std::vector<std::thread> capture_workers;
+
+inline FILE *capture_pipe = nullptr;
+inline std::atomic<bool> has_capture_encoder_exited{false};
+inline void (*previous_sigpipe_handler)(int) = SIG_DFL; // Restored once the encoder is closed
+inline int capture_width = 0, capture_height = 0; // Of the raw stream, which can't change size
+inline size_t capture_frame_count = 0;
+inline size_t dropped_capture_frames = 0;
+inline std::atomic<size_t> written_capture_frames{0};
+
+/* Quality Governor */
+
+struct quality_settings {
+    size_t parallax_layers;     // Quads of the parallax background, drawn from the back, so the furthest layer is the last to go
+    size_t victory_ball_count;
+    int render_scale;           // The scene is drawn at 1/render_scale of the window's resolution and scaled up
+    size_t animation_interval;  // Sprites change every this many ticks, and the animation system skips the others
+};
+
+// From the cheapest to the full quality
+inline const quality_settings QUALITY_LEVELS[] = {
+    {1,  250, 2, 4},
+    {2,  500, 2, 2},
+    {3, 1000, 1, 2},
+    {3, 2000, 1, 1}
+};
+inline const size_t QUALITY_LEVEL_COUNT = sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]);
+
+inline const size_t QUALITY_WINDOW_FRAMES    = 120;   // Frame times the percentile is taken over
+inline const float QUALITY_PERCENTILE        = 0.95f;
+inline const float QUALITY_STEP_DOWN_LOAD    = 1.15f; // Steps down when the percentile is above this part of the budget...
+inline const float QUALITY_STEP_UP_LOAD      = 1.05f; // ...and up when it stayed below this one for a while
+inline const size_t QUALITY_STEP_UP_FRAMES   = 600;
+
+struct quality_governor_state {
+    size_t level = QUALITY_LEVEL_COUNT - 1;
+    float frame_times_ms[QUALITY_WINDOW_FRAMES] = {};
+    size_t frame_count = 0;                 // Since the last change
+    size_t frames_with_headroom = 0;
+    float percentile_ms = 0.0f;
+    double previous_present_time = 0.0;
+    const char *last_decision = "none";
+    size_t last_decision_frame = 0;
+};
+
+inline quality_governor_state quality_governor;
+
 /* Game States */
 
 enum game_state {
@@ -198,6 +553,61 @@ enum game_state {
 };
 inline game_state game_state = MENU_STATE;
 
+/* Allocation Test */
+
+inline const size_t ALLOCATION_TEST_FRAMES        = 3600;
+inline const size_t ALLOCATION_TEST_WARMUP_FRAMES = 120;
+inline enum game_state allocation_test_frame_state = MENU_STATE;
+inline size_t allocation_test_failures = 0;
+
+/* Frame Snapshot */
+
+struct snapshot_image {
+    Vector2 position;  // In cells
+    Texture2D texture;
+};
+
+// Everything drawing a frame needs to know about the game, copied from it between two ticks, so that the frame
+// can be drawn while the next tick is already changing the game (the tiles are in the static tile chunks,
+// which are also baked between two ticks)
+struct frame_snapshot {
+    enum game_state state = MENU_STATE;
+    size_t frame = 0;
+    bool show_stats_overlay = false;
+
+    Vector2 player_position = {0.0f, 0.0f};
+    Texture2D player_texture = {};
+    int lives = 0;
+    int score = 0;
+    int timer = 0;
+    Texture2D hud_coin_texture = {};
+
+    std::vector<snapshot_image> items;   // Coins and exits
+    std::vector<snapshot_image> enemies;
+
+    // For the stats overlay
+    size_t entity_count = 0;
+    size_t archetype_count = 0;
+    size_t stage_count = 0;
+    size_t chase_field_searches = 0;
+    arena_stats level_arena_stats;
+};
+
+inline frame_snapshot render_snapshot;
+
+/* Pipelined Update */
+
+// Graphics work the simulation asks for, done by the main thread between two ticks, as it needs the GPU
+inline bool is_level_graphics_stale = false;
+inline bool is_victory_background_stale = false;
+
+inline std::thread update_worker;
+inline std::mutex update_tick_mutex;
+inline std::condition_variable update_tick_requested;
+inline std::condition_variable update_tick_finished;
+inline bool is_update_tick_running = false;
+inline bool is_update_worker_running = false;
+
 /* Forward Declarations */
 
 // GRAPHICS_H
@@ -205,6 +615,13 @@ void draw_text(Text &text);
 void derive_graphics_metrics_from_loaded_level();
 void draw_game_overlay();
 void draw_level();
+void invalidate_static_tiles();
+void invalidate_static_tile_column(size_t column);
+bool is_static_tile_chunk_visible(size_t chunk_index, Vector2 playerPos, float *chunk_x);
+void bake_visible_static_tiles(Vector2 playerPos);
+void draw_static_tiles();
+void unload_static_tiles();
+Texture2D get_player_texture();
 void draw_player();
 void draw_enemies();
 void draw_menu();
@@ -218,13 +635,47 @@ void animate_victory_menu_background();
 void draw_victory_menu_background();
 void draw_victory_menu();
 void draw_parallax_background();
+void draw_stats_overlay();
+void resize_scene_target();
+void unload_scene_target();
+void compose_still_background_layers();
+void unload_composed_background();
+void flush_scene();
+
+// SYSTEMS_H
+void gravity_system();
+void patrol_system();
+void chase_system();
+void animation_system();
+void contact_system();
+void register_systems();
+void run_systems();
+
+// DRAW_LIST_H
+void submit_texture(draw_layer layer, Texture2D texture, Rectangle source, Rectangle destination, size_t depth = 0);
+void submit_image(draw_layer layer, Texture2D image, Vector2 pos, float width, float height);
+void submit_image(draw_layer layer, Texture2D image, Vector2 pos, float size);
+void submit_text(draw_layer layer, const Font &font, const char *text, Vector2 pos, float size, float spacing, Color color);
+void flush_draw_list(draw_layer first = PARALLAX_LAYER, draw_layer last = HUD_LAYER);
+void reset_draw_stats();
 
 // ASSETS_H
+Font load_sdf_font(const char *file_name, const char *cache_file_name);
+bool load_sdf_font_cache(Font &font, const char *cache_file_name, long source_mod_time);
+void save_sdf_font_cache(const Font &font, Image atlas, const char *cache_file_name, long source_mod_time);
 void load_fonts();
 void unload_fonts();
+Texture2D load_texture(const char *file_name);
+void unload_texture(Texture2D texture);
+void match_texture_sampling(Texture2D &texture, float drawn_width);
+void match_sprite_sampling(sprite &sprite, float drawn_width);
+void match_image_sampling_to_metrics();
 
 void load_images();
 void unload_images();
+void load_background_layers();
+void unload_background_layers();
+Texture2D get_tile_texture(tile_texture texture);
 
 void draw_image(Texture2D image, Vector2 pos, float width, float height);
 void draw_image(Texture2D image, Vector2 pos, float size);
@@ -237,14 +688,101 @@ sprite load_sprite(
         size_t frames_to_skip = 3
 );
 void unload_sprite(sprite &sprite);
-void draw_sprite(sprite &sprite, Vector2 pos, float width, float height);
-void draw_sprite(sprite &sprite, Vector2 pos, float size);
+void advance_animation_clock();
+size_t get_sprite_frame_index(const sprite &sprite);
 
+Sound load_sound(const char *file_name);
+void unload_sound(Sound sound);
 void load_sounds();
 void unload_sounds();
 
+// AUDIO_H
+void play_sound(sound_id id);
+void mix_sound_event(const sound_event &event);
+void run_sound_mixer();
+void start_sound_mixer();
+void stop_sound_mixer();
+
+// INPUT_H
+void sample_input();
+bool is_action_down(game_action action);
+bool is_action_pressed(game_action action);
+void poll_input_edges();
+void push_input_edge(game_action action, bool is_down, double time);
+void poll_input_until_next_frame();
+void replay_input_events();
+float get_action_hold_fraction(game_action action);
+void latch_tick_input();
+void consume_input();
+
+// LATENCY_H
+void trace_input_consumed(double pressed_at);
+void trace_frame_presented();
+float latency_percentile(float *sorted_samples, size_t count, float percentile);
+void summarize_latency();
+void report_latency();
+void wait_for_late_input();
+void begin_frame_timing();
+void mark_frame_submitted();
+void end_frame_timing();
+
+// PIPELINE_H
+void update_game();
+void apply_deferred_graphics();
+void capture_render_snapshot();
+void sync_render_state();
+void run_update_worker();
+void start_update_worker();
+void stop_update_worker();
+void start_update_tick();
+void finish_update_tick();
+
+// MEMORY_H
+size_t estimate_texture_bytes(Texture2D texture);
+size_t estimate_render_texture_bytes(RenderTexture2D target);
+size_t estimate_sound_bytes(Sound sound);
+memory_usage estimate_font_memory(const Font &font);
+void add_memory_usage(memory_usage &total, memory_usage usage);
+void subtract_memory_usage(memory_usage &total, memory_usage usage);
+memory_usage measure_image_memory();
+memory_usage measure_font_memory();
+memory_usage measure_sound_memory();
+memory_usage measure_render_target_memory();
+memory_usage measure_level_memory();
+memory_usage measure_entity_memory();
+memory_usage measure_frame_memory();
+void add_memory_account(const char *name, memory_usage (*measure)());
+void register_memory_accounts();
+void raise_high_water(memory_usage &high_water, memory_usage usage);
+void report_level_memory_peak();
+void update_memory_accounts();
+void report_memory_accounts();
+
+// CAPTURE_H
+bool is_capturing_frames();
+void write_captured_frame(const captured_frame &frame);
+void run_capture_worker();
+void start_frame_capture();
+void capture_frame();
+void stop_frame_capture();
+
+// QUALITY_H
+const quality_settings &get_quality_settings();
+void record_quality_frame_time();
+bool update_quality_governor();
+
+// ALLOC_TEST_H
+void begin_allocation_frame();
+void script_allocation_test_input();
+bool is_allocation_test_over();
+int finish_allocation_test();
+
+// OPTIONS_H
+void parse_launch_options(int argc, char **argv);
+
 // UTILITIES_H
 float rand_from_to(float from, float to);
 float rand_up_to(float to);
+const char *frame_format(const char *format, ...);
 
 #endif // GLOBALS_H
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "player.h"
 #include "level.h"
 #include "enemy.h"
+#include "alloc_tracker.h"
 
 void draw_text(Text &text) {
     // Measure the text, center it to the required position, and draw it
@@ -17,22 +18,22 @@ void draw_text(Text &text) {
         (screen_size.y * text.position.y) - (0.5f * dimensions.y)
     };
 
+    BeginShaderMode(sdf_font_shader);
     DrawTextEx(*text.font, text.str.c_str(), pos, dimensions.y, text.spacing, text.color);
+    EndShaderMode();
 }
 
 void derive_graphics_metrics_from_loaded_level() {
-    // Get Level instance
-    Level* level = Level::getInstance();
-    const struct level& currentLevel = level->getCurrentLevel();
-
     // Level and UI setup
     screen_size.x = static_cast<float>(GetScreenWidth());
     screen_size.y = static_cast<float>(GetScreenHeight());
 
+    resize_scene_target();
+
     // For very wide levels, use a reasonable cell size that fits the screen height
     // while allowing a good view distance
     float ideal_visible_rows = 12.0f; // Aim to see about 12 rows at once
-    cell_size = screen_size.y / ideal_visible_rows;
+    cell_size = scene_size.y / ideal_visible_rows;
 
     // Make sure the cell size isn't too small
     cell_size = std::max(cell_size, 20.0f);
@@ -41,127 +42,313 @@ void derive_graphics_metrics_from_loaded_level() {
     screen_scale = std::min(screen_size.x, screen_size.y) / SCREEN_SCALE_DIVISOR;
 
     // Parallax background setup
-    float larger_screen_side = std::max(screen_size.x, screen_size.y);
+    float larger_screen_side = std::max(scene_size.x, scene_size.y);
 
-    if (screen_size.x > screen_size.y) {
+    if (scene_size.x > scene_size.y) {
         background_size = {larger_screen_side, larger_screen_side / 16 * 10};
     }
     else {
         background_size = {larger_screen_side / 10 * 16, larger_screen_side};
     }
 
-    background_y_offset = (screen_size.y - background_size.y) * 0.5f;
+    background_y_offset = (scene_size.y - background_size.y) * 0.5f;
+
+    match_image_sampling_to_metrics();
+    compose_still_background_layers();
+}
+
+void resize_scene_target() {
+    int render_scale = get_quality_settings().render_scale;
+    if (!launch_options.low_res_scene && render_scale == 1) {
+        scene_size = screen_size;
+        scene_scale = 1;
+        unload_scene_target();
+        return;
+    }
+
+    // The largest whole scale that keeps the scene at least LOW_RES_SCENE_HEIGHT pixels tall, so that every
+    // scene pixel becomes a k x k block of window pixels without any filtering; the quality may lower it further
+    scene_scale = launch_options.low_res_scene ? std::max(1, static_cast<int>(screen_size.y / LOW_RES_SCENE_HEIGHT)) : 1;
+    scene_scale = std::max(scene_scale, render_scale);
+    int width = static_cast<int>(ceilf(screen_size.x / scene_scale));
+    int height = static_cast<int>(ceilf(screen_size.y / scene_scale));
+    scene_size = {static_cast<float>(width), static_cast<float>(height)};
+
+    if (scene_target.id != 0 && scene_target.texture.width == width && scene_target.texture.height == height) {
+        return;
+    }
+    unload_scene_target();
+    scene_target = LoadRenderTexture(width, height);
+    SetTextureFilter(scene_target.texture, TEXTURE_FILTER_POINT);
+}
+
+void unload_scene_target() {
+    if (scene_target.id != 0) {
+        UnloadRenderTexture(scene_target);
+        scene_target = {};
+    }
+}
+
+void compose_still_background_layers() {
+    unload_composed_background();
+    if (composed_background_layers == 0) return;
+
+    composed_background_target = LoadRenderTexture(
+        static_cast<int>(ceilf(background_size.x)),
+        static_cast<int>(ceilf(background_size.y))
+    );
+    SetTextureFilter(composed_background_target.texture, TEXTURE_FILTER_POINT);
+
+    BeginTextureMode(composed_background_target);
+    ClearBackground(BLANK);
+    for (size_t i = 0; i < composed_background_layers; ++i) {
+        draw_image(background_layers[i].texture, {0.0f, 0.0f}, background_size.x, background_size.y);
+    }
+    EndTextureMode();
+}
+
+void unload_composed_background() {
+    if (composed_background_target.id != 0) {
+        UnloadRenderTexture(composed_background_target);
+        composed_background_target = {};
+    }
+}
+
+void flush_scene() {
+    // Draws the scene layers of the draw list, through the low-resolution target if there is one;
+    // the HUD layer is left in the list to be drawn on top at the window's resolution
+    if (scene_target.id == 0) {
+        flush_draw_list(PARALLAX_LAYER, ENTITY_LAYER);
+        return;
+    }
+
+    BeginTextureMode(scene_target);
+    ClearBackground(BLACK);
+    flush_draw_list(PARALLAX_LAYER, ENTITY_LAYER);
+    EndTextureMode();
+
+    // Render textures are stored upside down, hence the negative source height
+    Texture2D texture = scene_target.texture;
+    Rectangle source = { 0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height) };
+    Rectangle destination = {
+        0.0f, 0.0f,
+        static_cast<float>(texture.width * scene_scale), static_cast<float>(texture.height * scene_scale)
+    };
+    DrawTexturePro(texture, source, destination, { 0.0f, 0.0f }, 0.0f, WHITE);
+    ++frame_draw_stats.draw_calls;
 }
 
 void draw_parallax_background() {
-    // First uses the player's position
-    Player* player = Player::getInstance();
-    float player_x = player->getPosition().x;
-    float initial_offset = -(player_x * PARALLAX_PLAYER_SCROLLING_SPEED + game_frame * PARALLAX_IDLE_SCROLLING_SPEED);
-
-    // Calculate offsets for different layers
-    float background_offset   = initial_offset;
-    float middleground_offset = background_offset * PARALLAX_LAYERED_SPEED_DIFFERENCE;
-    float foreground_offset   = middleground_offset * PARALLAX_LAYERED_SPEED_DIFFERENCE;
-
-    // Wrap offsets to create a loop effect
-    background_offset   = fmod(background_offset, 1.0f);
-    middleground_offset = fmod(middleground_offset, 1.0f);
-    foreground_offset   = fmod(foreground_offset, 1.0f);
-
-    // Scale to background size
-    background_offset   *= background_size.x;
-    middleground_offset *= background_size.x;
-    foreground_offset   *= background_size.x;
-
-    // Each layer is drawn twice, side by side, the first starting from its offset, and the other from its offset + background_size
-    // This ensures a seamless scrolling effect, because when one copy moves out of sight, the second jumps into its place.
-    draw_image(background,   {background_offset + background_size.x, background_y_offset},   background_size.x, background_size.y);
-    draw_image(background,   {background_offset,                     background_y_offset},   background_size.x, background_size.y);
-
-    draw_image(middleground, {middleground_offset + background_size.x, background_y_offset}, background_size.x, background_size.y);
-    draw_image(middleground, {middleground_offset,                     background_y_offset}, background_size.x, background_size.y);
-
-    draw_image(foreground,   {foreground_offset + background_size.x, background_y_offset},   background_size.x, background_size.y);
-    draw_image(foreground,   {foreground_offset,                     background_y_offset},   background_size.x, background_size.y);
+    // Uses the player's position, and keeps drifting slowly when the player stands still
+    float player_x = render_snapshot.player_position.x;
+    float scroll = -(player_x * PARALLAX_PLAYER_SCROLLING_SPEED + render_snapshot.frame * PARALLAX_IDLE_SCROLLING_SPEED);
+
+    // Every layer covers the background with one quad, and scrolls by sampling its texture from an offset instead of
+    // moving; the texture repeats, so the part that scrolls out on one side comes back in on the other.
+    // The depth keeps the layers in order, as the draw list would otherwise group them by texture.
+    // Lower qualities leave out the layers in front first.
+    Rectangle destination = {0.0f, background_y_offset, background_size.x, background_size.y};
+    size_t quad_count = get_quality_settings().parallax_layers;
+    size_t depth = 0;
+    size_t first_layer = 0;
+    if (composed_background_target.id != 0) {
+        // Render textures are stored upside down, hence the negative source height
+        Texture2D texture = composed_background_target.texture;
+        Rectangle source = {0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height)};
+        submit_texture(PARALLAX_LAYER, texture, source, destination, depth++);
+        first_layer = composed_background_layers;
+    }
+
+    for (size_t i = first_layer; i < background_layers.size() && depth < quad_count; ++i) {
+        const parallax_layer &layer = background_layers[i];
+        float width = static_cast<float>(layer.texture.width);
+        float height = static_cast<float>(layer.texture.height);
+
+        // Wrapped to a single width, so the texture coordinates stay small enough to be precise
+        float offset = fmodf(scroll * layer.speed, 1.0f) * width;
+        submit_texture(PARALLAX_LAYER, layer.texture, {-offset, 0.0f, width, height}, destination, depth++);
+    }
 }
 
 void draw_game_overlay() {
-    Player* player = Player::getInstance();
-    const float ICON_SIZE = 48.0f * screen_scale;
+    const float ICON_SIZE = HUD_ICON_SIZE * screen_scale;
 
     float slight_vertical_offset = 8.0f;
     slight_vertical_offset *= screen_scale;
 
     // Hearts
-    for (int i = 0; i < player->getLives(); i++) {
+    for (int i = 0; i < render_snapshot.lives; i++) {
         const float SPACE_BETWEEN_HEARTS = 4.0f * screen_scale;
-        draw_image(heart_image, {ICON_SIZE * i + SPACE_BETWEEN_HEARTS, slight_vertical_offset}, ICON_SIZE);
+        submit_image(HUD_LAYER, heart_image, {ICON_SIZE * i + SPACE_BETWEEN_HEARTS, slight_vertical_offset}, ICON_SIZE);
     }
 
     // Timer
-    Vector2 timer_dimensions = MeasureTextEx(menu_font, std::to_string(timer / 60).c_str(), ICON_SIZE, 2.0f);
+    const char *timer_text = frame_format("%d", render_snapshot.timer / 60);
+    Vector2 timer_dimensions = MeasureTextEx(menu_font, timer_text, ICON_SIZE, 2.0f);
     Vector2 timer_position = {(GetRenderWidth() - timer_dimensions.x) * 0.5f, slight_vertical_offset};
-    DrawTextEx(menu_font, std::to_string(timer / 60).c_str(), timer_position, ICON_SIZE, 2.0f, WHITE);
+    submit_text(HUD_LAYER, menu_font, timer_text, timer_position, ICON_SIZE, 2.0f, WHITE);
 
     // Score
-    Vector2 score_dimensions = MeasureTextEx(menu_font, std::to_string(player->getTotalScore()).c_str(), ICON_SIZE, 2.0f);
+    const char *score_text = frame_format("%d", render_snapshot.score);
+    Vector2 score_dimensions = MeasureTextEx(menu_font, score_text, ICON_SIZE, 2.0f);
     Vector2 score_position = {GetRenderWidth() - score_dimensions.x - ICON_SIZE, slight_vertical_offset};
-    DrawTextEx(menu_font, std::to_string(player->getTotalScore()).c_str(), score_position, ICON_SIZE, 2.0f, WHITE);
-    draw_sprite(coin_sprite, {GetRenderWidth() - ICON_SIZE, slight_vertical_offset}, ICON_SIZE);
+    submit_text(HUD_LAYER, menu_font, score_text, score_position, ICON_SIZE, 2.0f, WHITE);
+    submit_image(HUD_LAYER, render_snapshot.hud_coin_texture, {GetRenderWidth() - ICON_SIZE, slight_vertical_offset}, ICON_SIZE);
 }
 
 void draw_level() {
-    Player* player = Player::getInstance();
+    Vector2 playerPos = render_snapshot.player_position;
+
+    // Move the x-axis' center to the middle of the screen
+    horizontal_shift = (scene_size.x - cell_size) / 2;
+
+    // Static tiles
+    draw_static_tiles();
+
+    // Coins and exits
+    for (const snapshot_image &item : render_snapshot.items) {
+        Vector2 pos = {
+            (item.position.x - playerPos.x) * cell_size + horizontal_shift,
+            item.position.y * cell_size
+        };
+        submit_image(ITEM_LAYER, item.texture, pos, cell_size);
+    }
+
+    draw_player();
+    draw_enemies();
+}
+
+void invalidate_static_tiles() {
+    // Called when a new level is loaded or the cell size changes; the chunks are baked again
+    // by bake_visible_static_tiles() as they come into view
+    unload_static_tiles();
+
+    const struct level& currentLevel = Level::getInstance()->getCurrentLevel();
+    size_t chunk_count = (currentLevel.columns + STATIC_TILE_CHUNK_COLUMNS - 1) / STATIC_TILE_CHUNK_COLUMNS;
+    static_tile_chunks.resize(chunk_count);
+}
+
+void invalidate_static_tile_column(size_t column) {
+    size_t chunk = column / STATIC_TILE_CHUNK_COLUMNS;
+    if (chunk < static_tile_chunks.size()) {
+        static_tile_chunks[chunk].is_dirty = true;
+    }
+}
+
+void bake_static_tile_chunk(size_t chunk_index) {
     Level* level = Level::getInstance();
-    Vector2 playerPos = player->getPosition();
     const struct level& currentLevel = level->getCurrentLevel();
+    static_tile_chunk &chunk = static_tile_chunks[chunk_index];
 
-    // Move the x-axis' center to the middle of the screen
-    horizontal_shift = (screen_size.x - cell_size) / 2;
-
-    for (size_t row = 0; row < currentLevel.rows; ++row) {
-        for (size_t column = 0; column < currentLevel.columns; ++column) {
-
-            Vector2 pos = {
-                    // Move the level to the left as the player advances to the right,
-                    // shifting to the left to allow the player to be centered later
-                    (static_cast<float>(column) - playerPos.x) * cell_size + horizontal_shift,
-                    static_cast<float>(row) * cell_size
-            };
-
-            // Draw the level itself
-            char cell = level->getLevelCell(row, column);
-            switch (cell) {
-                case WALL:
-                    draw_image(wall_image, pos, cell_size);
-                    break;
-                case WALL_DARK:
-                    draw_image(wall_dark_image, pos, cell_size);
-                    break;
-                case SPIKE:
-                    draw_image(spike_image, pos, cell_size);
-                    break;
-                case COIN:
-                    draw_sprite(coin_sprite, pos, cell_size);
-                    break;
-                case EXIT:
-                    draw_image(exit_image, pos, cell_size);
-                    break;
-                default:
-                    break;
+    if (chunk.target.id == 0) {
+        chunk.target = LoadRenderTexture(
+            static_cast<int>(ceilf(STATIC_TILE_CHUNK_COLUMNS * cell_size)),
+            static_cast<int>(ceilf(currentLevel.rows * cell_size))
+        );
+    }
+
+    size_t first_column = chunk_index * STATIC_TILE_CHUNK_COLUMNS;
+    size_t last_column = std::min(first_column + STATIC_TILE_CHUNK_COLUMNS, currentLevel.columns);
+
+    BeginTextureMode(chunk.target);
+    ClearBackground(BLANK);
+    for (size_t chunk_row = 0; chunk_row < currentLevel.chunk_rows; ++chunk_row) {
+        for (size_t chunk_column = first_column / LEVEL_CHUNK_SIZE; chunk_column * LEVEL_CHUNK_SIZE < last_column; ++chunk_column) {
+            // Chunks of the level that are all air have nothing to draw
+            const char *cells = level->getChunk(chunk_row, chunk_column);
+            if (cells == nullptr) continue;
+
+            size_t last_row = std::min((chunk_row + 1) * LEVEL_CHUNK_SIZE, currentLevel.rows);
+            size_t chunk_first_column = std::max(chunk_column * LEVEL_CHUNK_SIZE, first_column);
+            size_t chunk_last_column = std::min((chunk_column + 1) * LEVEL_CHUNK_SIZE, last_column);
+            for (size_t row = chunk_row * LEVEL_CHUNK_SIZE; row < last_row; ++row) {
+                for (size_t column = chunk_first_column; column < chunk_last_column; ++column) {
+                    Vector2 pos = {
+                        static_cast<float>(column - first_column) * cell_size,
+                        static_cast<float>(row) * cell_size
+                    };
+
+                    char cell = cells[(row % LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE + column % LEVEL_CHUNK_SIZE];
+                    const tile_traits &traits = get_tile_traits(cell);
+                    if (traits.flags & DRAWABLE_TILE) {
+                        draw_image(get_tile_texture(traits.texture), pos, cell_size);
+                    }
+                }
             }
         }
     }
+    EndTextureMode();
 
-    draw_player();
-    draw_enemies();
+    chunk.is_dirty = false;
 }
 
-void draw_player() {
+bool is_static_tile_chunk_visible(size_t chunk_index, Vector2 playerPos, float *chunk_x) {
+    horizontal_shift = (scene_size.x - cell_size) / 2;
+    *chunk_x = (static_cast<float>(chunk_index * STATIC_TILE_CHUNK_COLUMNS) - playerPos.x) * cell_size + horizontal_shift;
+    float chunk_width = STATIC_TILE_CHUNK_COLUMNS * cell_size;
+    return *chunk_x + chunk_width >= 0.0f && *chunk_x <= scene_size.x;
+}
+
+void bake_visible_static_tiles(Vector2 playerPos) {
+    // Done between two ticks, as baking reads the level grid, which the next tick may be changing while drawing
+
+    // Chunks baked for another cell size (e.g., before the window was resized) have to be recreated
+    if (static_tile_chunks_cell_size != cell_size) {
+        invalidate_static_tiles();
+        static_tile_chunks_cell_size = cell_size;
+    }
+
+    for (size_t i = 0; i < static_tile_chunks.size(); ++i) {
+        float chunk_x;
+        if (static_tile_chunks[i].is_dirty && is_static_tile_chunk_visible(i, playerPos, &chunk_x)) {
+            bake_static_tile_chunk(i);
+        }
+    }
+}
+
+void draw_static_tiles() {
+    for (size_t i = 0; i < static_tile_chunks.size(); ++i) {
+        // Skip the chunks that are off-screen, and the ones that were not baked in time to be shown
+        float chunk_x;
+        if (!is_static_tile_chunk_visible(i, render_snapshot.player_position, &chunk_x)) continue;
+        if (static_tile_chunks[i].target.id == 0) continue;
+
+        // Render textures are stored upside down, hence the negative source height
+        Texture2D texture = static_tile_chunks[i].target.texture;
+        Rectangle source = { 0.0f, 0.0f, static_cast<float>(texture.width), -static_cast<float>(texture.height) };
+        Rectangle destination = { chunk_x, 0.0f, static_cast<float>(texture.width), static_cast<float>(texture.height) };
+        submit_texture(TILE_LAYER, texture, source, destination);
+    }
+}
+
+void unload_static_tiles() {
+    for (auto &chunk : static_tile_chunks) {
+        if (chunk.target.id != 0) {
+            UnloadRenderTexture(chunk.target);
+        }
+    }
+    static_tile_chunks.clear();
+}
+
+Texture2D get_player_texture() {
+    // Pick an appropriate sprite for the player
     Player* player = Player::getInstance();
-    Vector2 playerPos = player->getPosition();
-    horizontal_shift = (screen_size.x - cell_size) / 2;
+    if (game_state != GAME_STATE) {
+        return player_dead_image;
+    }
+    if (!player->isOnGround()) {
+        return player->isLookingForward() ? player_jump_forward_image : player_jump_backwards_image;
+    }
+    if (player->isMoving()) {
+        const sprite &walk = player->isLookingForward() ? player_walk_forward_sprite : player_walk_backwards_sprite;
+        return walk.frames[get_sprite_frame_index(walk)];
+    }
+    return player->isLookingForward() ? player_stand_forward_image : player_stand_backwards_image;
+}
+
+void draw_player() {
+    Vector2 playerPos = render_snapshot.player_position;
+    horizontal_shift = (scene_size.x - cell_size) / 2;
 
     // Shift the camera to the center of the screen to allow to see what is in front of the player
     Vector2 pos = {
@@ -169,42 +356,77 @@ void draw_player() {
             playerPos.y * cell_size
     };
 
-    // Pick an appropriate sprite for the player
-    if (game_state == GAME_STATE) {
-        if (!player->isOnGround()) {
-            draw_image((player->isLookingForward() ? player_jump_forward_image : player_jump_backwards_image), pos, cell_size);
-        }
-        else if (player->isMoving()) {
-            draw_sprite((player->isLookingForward() ? player_walk_forward_sprite : player_walk_backwards_sprite), pos, cell_size);
-            player->setMoving(false);
-        }
-        else {
-            draw_image((player->isLookingForward() ? player_stand_forward_image : player_stand_backwards_image), pos, cell_size);
-        }
-    }
-    else {
-        draw_image(player_dead_image, pos, cell_size);
-    }
+    submit_image(ENTITY_LAYER, render_snapshot.player_texture, pos, cell_size);
 }
 
 void draw_enemies() {
-    Player* player = Player::getInstance();
-    Vector2 playerPos = player->getPosition();
-
-    // Get all enemies from the Enemy class
-    const std::vector<Enemy>& allEnemies = Enemy::getAllEnemies();
+    Vector2 playerPos = render_snapshot.player_position;
 
     // Go over all enemies and draw them, accounting for the player's movement and horizontal shift
-    for (const auto &enemy : allEnemies) {
-        horizontal_shift = (screen_size.x - cell_size) / 2;
-
+    horizontal_shift = (scene_size.x - cell_size) / 2;
+    for (const snapshot_image &enemy : render_snapshot.enemies) {
         Vector2 pos = {
-            (enemy.getPosition().x - playerPos.x) * cell_size + horizontal_shift,
-            enemy.getPosition().y * cell_size
+            (enemy.position.x - playerPos.x) * cell_size + horizontal_shift,
+            enemy.position.y * cell_size
         };
+        submit_image(ENTITY_LAYER, enemy.texture, pos, cell_size);
+    }
+}
 
-        draw_sprite(enemy_walk, pos, cell_size);
+void draw_stats_overlay() {
+    if (!render_snapshot.show_stats_overlay) return;
+
+    const arena_stats &level_arena_stats = render_snapshot.level_arena_stats;
+    const arena_stats &frame_arena_stats = frame_arena.getStats();
+    allocation_counts heap_update = AllocationTracker::getFrameCounts(UPDATE_ZONE);
+    allocation_counts heap_draw = AllocationTracker::getFrameCounts(DRAW_ZONE);
+    const char *lines[] = {
+        AllocationTracker::isEnabled()
+            ? frame_format("Heap: %zu + %zu allocations in update + draw", heap_update.allocations, heap_draw.allocations)
+            : "Heap: not tracked",
+        frame_format("Scene: %dx%d, scaled by %d", static_cast<int>(scene_size.x), static_cast<int>(scene_size.y), scene_scale),
+        frame_format("Draw calls: %zu", frame_draw_stats.draw_calls),
+        frame_format("Quality: %zu/%zu, %.0fth percentile frame %.1f ms of %.1f, %s at frame %zu",
+                     quality_governor.level, QUALITY_LEVEL_COUNT - 1, QUALITY_PERCENTILE * 100.0f,
+                     quality_governor.percentile_ms, 1000.0f / TARGET_FRAME_RATE,
+                     quality_governor.last_decision, quality_governor.last_decision_frame),
+        frame_format("Quality settings: %zu parallax layers, %zu balls, scene / %d, sprites every %zu ticks",
+                     get_quality_settings().parallax_layers, get_quality_settings().victory_ball_count,
+                     get_quality_settings().render_scale, get_quality_settings().animation_interval),
+        frame_format("Entities: %zu in %zu archetypes, %zu stages on %zu workers",
+                     render_snapshot.entity_count, render_snapshot.archetype_count,
+                     render_snapshot.stage_count, system_scheduler.getWorkerCount()),
+        frame_format("Chase field: %zu searches", render_snapshot.chase_field_searches),
+        frame_format("Batches: %zu", frame_draw_stats.batches),
+        frame_format("Level arena: %zu/%zu KiB, %zu heap blocks",
+                     level_arena_stats.used_bytes / 1024, level_arena_stats.capacity_bytes / 1024,
+                     level_arena_stats.heap_allocations),
+        frame_format("Frame arena: %zu/%zu KiB, %zu heap blocks",
+                     frame_arena_stats.high_water_bytes / 1024, frame_arena_stats.capacity_bytes / 1024,
+                     frame_arena_stats.heap_allocations),
+        frame_format("Memory: %zu KiB CPU, %zu KiB GPU", memory_total.cpu_bytes / 1024, memory_total.gpu_bytes / 1024)
+    };
+
+    const float FONT_SIZE = 12.0f * screen_scale;
+    const float LINE_HEIGHT = FONT_SIZE * 1.5f;
+    const size_t LINE_COUNT = sizeof(lines) / sizeof(lines[0]) + memory_account_count;
+    Vector2 pos = {8.0f * screen_scale, screen_size.y - LINE_COUNT * LINE_HEIGHT};
+    BeginShaderMode(sdf_font_shader);
+    for (const char *line : lines) {
+        DrawTextEx(menu_font, line, pos, FONT_SIZE, 1.0f, YELLOW);
+        pos.y += LINE_HEIGHT;
     }
+
+    // One line per memory account, below the total
+    for (size_t i = 0; i < memory_account_count; ++i) {
+        const memory_account &account = memory_accounts[i];
+        const char *line = frame_format("  %s: %zu KiB CPU, %zu KiB GPU, level peak %zu + %zu KiB", account.name,
+                                        account.current.cpu_bytes / 1024, account.current.gpu_bytes / 1024,
+                                        account.level_high_water.cpu_bytes / 1024, account.level_high_water.gpu_bytes / 1024);
+        DrawTextEx(menu_font, line, pos, FONT_SIZE, 1.0f, YELLOW);
+        pos.y += LINE_HEIGHT;
+    }
+    EndShaderMode();
 }
 
 // Menus
@@ -221,6 +443,8 @@ void draw_death_screen() {
     draw_parallax_background();
     draw_level();
     draw_game_overlay();
+    flush_scene();
+    flush_draw_list();
     DrawRectangle(0, 0, GetRenderWidth(), GetRenderHeight(), {0, 0, 0, 100});
     draw_text(death_title);
     draw_text(death_subtitle);
@@ -246,16 +470,16 @@ void create_victory_menu_background() {
     }
 
     /* Clear both the front buffer and the back buffer to avoid ghosting of the game graphics. */
-    ClearBackground(BLACK);
-    EndDrawing();
-    BeginDrawing();
-    ClearBackground(BLACK);
-    EndDrawing();
-    BeginDrawing();
+    for (int i = 0; i < 2; ++i) {
+        BeginDrawing();
+        ClearBackground(BLACK);
+        EndDrawing();
+    }
 }
 
 void animate_victory_menu_background() {
-    for (auto &ball : victory_balls) {
+    for (size_t i = 0; i < get_quality_settings().victory_ball_count; ++i) {
+        victory_ball &ball = victory_balls[i];
         ball.x += ball.dx;
         if (ball.x - ball.radius < 0 ||
             ball.x + ball.radius >= screen_size.x) {
@@ -270,7 +494,8 @@ void animate_victory_menu_background() {
 }
 
 void draw_victory_menu_background() {
-    for (auto &ball : victory_balls) {
+    for (size_t i = 0; i < get_quality_settings().victory_ball_count; ++i) {
+        const victory_ball &ball = victory_balls[i];
         DrawCircleV({ ball.x, ball.y }, ball.radius, VICTORY_BALL_COLOR);
     }
 }
@@ -0,0 +1,178 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// This is input.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <algorithm>
+
+// Keys bound to every action, terminated by KEY_NULL
+inline const int ACTION_KEYS[ACTION_COUNT][4] = {
+    { KEY_RIGHT,  KEY_D,    KEY_NULL            }, // MOVE_RIGHT_ACTION
+    { KEY_LEFT,   KEY_A,    KEY_NULL            }, // MOVE_LEFT_ACTION
+    { KEY_UP,     KEY_W,    KEY_SPACE, KEY_NULL }, // JUMP_ACTION
+    { KEY_ENTER,  KEY_NULL                      }, // CONFIRM_ACTION
+    { KEY_ESCAPE, KEY_NULL                      }, // PAUSE_ACTION
+    { KEY_F3,     KEY_NULL                      }  // TOGGLE_STATS_ACTION
+};
+
+void sample_input() {
+    if (launch_options.poll_input) {
+        poll_input_edges();
+        return;
+    }
+
+    // Presses are latched until a tick consumes them, so sampling more than once per tick never loses one
+    double now = GetTime();
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        bool is_down = false;
+        bool is_pressed = false;
+        for (const int *key = ACTION_KEYS[action]; *key != KEY_NULL; ++key) {
+            is_down = is_down || IsKeyDown(*key);
+            is_pressed = is_pressed || IsKeyPressed(*key);
+        }
+        is_pressed = is_pressed || (is_down && !current_input.is_down[action]);
+
+        if (is_pressed && !current_input.was_pressed[action]) {
+            current_input.was_pressed[action] = true;
+            current_input.pressed_at[action] = now;
+        }
+        current_input.is_down[action] = is_down;
+    }
+}
+
+void poll_input_edges() {
+    // Only the main thread may pump the window's events, so this is where the keyboard is polled; every change
+    // goes into the queue with the time it was seen at, for the next tick to replay
+    double now = GetTime();
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        bool is_down = false;
+        bool is_pressed = false;
+        for (const int *key = ACTION_KEYS[action]; *key != KEY_NULL; ++key) {
+            is_down = is_down || IsKeyDown(*key);
+            is_pressed = is_pressed || IsKeyPressed(*key);
+        }
+
+        // A tap that was already over when polled is a press and a release at the same time
+        if (is_pressed && !polled_input_down[action]) {
+            push_input_edge(static_cast<game_action>(action), true, now);
+        }
+        if (is_down != polled_input_down[action]) {
+            push_input_edge(static_cast<game_action>(action), is_down, now);
+        }
+    }
+}
+
+void push_input_edge(game_action action, bool is_down, double time) {
+    // If the queue is full, the edge is pushed again by the next poll, as the polled state did not change
+    if (input_events.tryPush({action, is_down, time})) {
+        polled_input_down[action] = is_down;
+    }
+}
+
+void poll_input_until_next_frame() {
+    // Spends the rest of the frame polling the input, instead of sleeping through it in EndDrawing()
+    double now = GetTime();
+    next_polled_frame_at = std::max(next_polled_frame_at + 1.0 / TARGET_FRAME_RATE, now);
+    while (now < next_polled_frame_at) {
+        WaitTime(std::min(INPUT_POLL_INTERVAL, next_polled_frame_at - now));
+        PollInputEvents();
+        poll_input_edges();
+        now = GetTime();
+    }
+}
+
+void replay_input_events() {
+    // Called by the tick itself, as it is the consumer of the queue. Every edge seen during the tick's time span
+    // is applied in order, which also gives how much of that span each action was down for.
+    if (!launch_options.poll_input) return;
+
+    double from = tick_input_from;
+    double until = std::max(tick_input_until, from);
+    double down_since[ACTION_COUNT];
+    double held_time[ACTION_COUNT] = {};
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        down_since[action] = from;
+    }
+
+    while (true) {
+        input_event event;
+        if (has_carried_input_event) {
+            event = carried_input_event;
+            has_carried_input_event = false;
+        }
+        else if (!input_events.tryPop(event)) {
+            break;
+        }
+
+        // Seen after the tick's time span ended, so it is left for the next tick
+        if (event.time > until) {
+            carried_input_event = event;
+            has_carried_input_event = true;
+            break;
+        }
+
+        size_t action = event.action;
+        double time = std::max(event.time, from);
+        if (event.is_down && !tick_input.is_down[action]) {
+            down_since[action] = time;
+            if (!tick_input.was_pressed[action]) {
+                tick_input.was_pressed[action] = true;
+                tick_input.pressed_at[action] = event.time;
+            }
+        }
+        else if (!event.is_down && tick_input.is_down[action]) {
+            held_time[action] += time - down_since[action];
+        }
+        tick_input.is_down[action] = event.is_down;
+    }
+
+    double span = until - from;
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        if (tick_input.is_down[action]) {
+            held_time[action] += until - down_since[action];
+        }
+        tick_input.held_for[action] = span > 0.0 ? static_cast<float>(std::min(held_time[action] / span, 1.0)) : 0.0f;
+    }
+}
+
+bool is_action_down(game_action action) {
+    // Down at any point of the tick, so that a tap shorter than a tick still counts
+    return tick_input.is_down[action] || tick_input.was_pressed[action];
+}
+
+bool is_action_pressed(game_action action) {
+    return tick_input.was_pressed[action];
+}
+
+float get_action_hold_fraction(game_action action) {
+    return tick_input.held_for[action];
+}
+
+void latch_tick_input() {
+    // With polling, the tick replays the key edges of the time since the previous one by itself
+    if (launch_options.poll_input) {
+        tick_input_from = tick_input_until;
+        tick_input_until = GetTime();
+        return;
+    }
+
+    // The tick gets its own copy, so the keyboard can be sampled again while it runs on another thread
+    tick_input = current_input;
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        tick_input.held_for[action] = tick_input.is_down[action] ? 1.0f : 0.0f;
+        current_input.was_pressed[action] = false;
+    }
+}
+
+void consume_input() {
+    for (size_t action = 0; action < ACTION_COUNT; ++action) {
+        if (tick_input.was_pressed[action]) {
+            trace_input_consumed(tick_input.pressed_at[action]);
+            tick_input.was_pressed[action] = false;
+        }
+    }
+}
+
+#endif // INPUT_H
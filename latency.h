@@ -0,0 +1,109 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+// This is latency.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <algorithm>
+
+void trace_input_consumed(double pressed_at) {
+    if (!launch_options.trace_latency) return;
+
+    // The press is only complete once the frame showing its effect has been presented
+    if (pending_latency_count < MAX_PENDING_LATENCY_SAMPLES) {
+        pending_latency_samples[pending_latency_count++] = {pressed_at, GetTime(), game_frame};
+    }
+}
+
+void trace_frame_presented() {
+    // Only records the samples; sorting them here would add to the latency being measured
+    if (!launch_options.trace_latency || pending_latency_count == 0) return;
+
+    double presented_at = GetTime();
+    for (size_t i = 0; i < pending_latency_count; ++i) {
+        const latency_sample &sample = pending_latency_samples[i];
+        float input_to_tick = static_cast<float>((sample.consumed_at - sample.pressed_at) * 1000.0);
+        float input_to_present = static_cast<float>((presented_at - sample.pressed_at) * 1000.0);
+
+        input_to_tick_ms[latency_sample_count % LATENCY_SAMPLE_CAPACITY] = input_to_tick;
+        input_to_present_ms[latency_sample_count % LATENCY_SAMPLE_CAPACITY] = input_to_present;
+        ++latency_sample_count;
+    }
+    pending_latency_count = 0;
+}
+
+float latency_percentile(float *sorted_samples, size_t count, float percentile) {
+    size_t index = static_cast<size_t>(percentile * static_cast<float>(count - 1) + 0.5f);
+    return sorted_samples[std::min(index, count - 1)];
+}
+
+void summarize_latency() {
+    static float sorted[LATENCY_SAMPLE_CAPACITY];
+
+    size_t count = std::min(latency_sample_count, LATENCY_SAMPLE_CAPACITY);
+    if (count == 0) return;
+
+    std::copy(input_to_present_ms, input_to_present_ms + count, sorted);
+    std::sort(sorted, sorted + count);
+    latency_stats.samples = latency_sample_count;
+    latency_stats.p50_ms = latency_percentile(sorted, count, 0.50f);
+    latency_stats.p90_ms = latency_percentile(sorted, count, 0.90f);
+    latency_stats.p99_ms = latency_percentile(sorted, count, 0.99f);
+    latency_stats.max_ms = sorted[count - 1];
+
+    float input_to_tick_total = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        input_to_tick_total += input_to_tick_ms[i];
+    }
+    latency_stats.mean_input_to_tick_ms = input_to_tick_total / static_cast<float>(count);
+}
+
+void report_latency() {
+    if (!launch_options.trace_latency) return;
+
+    summarize_latency();
+
+    if (latency_stats.samples == 0) {
+        TraceLog(LOG_INFO, "LATENCY: No input was recorded");
+        return;
+    }
+    TraceLog(LOG_INFO, "LATENCY: %zu inputs (%s input, vsync %s)", latency_stats.samples,
+             launch_options.late_input ? "late" : "early", launch_options.vsync ? "on" : "off");
+    TraceLog(LOG_INFO, "LATENCY: Input to present p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms",
+             latency_stats.p50_ms, latency_stats.p90_ms, latency_stats.p99_ms, latency_stats.max_ms);
+    TraceLog(LOG_INFO, "LATENCY: Input to tick mean %.2f ms", latency_stats.mean_input_to_tick_ms);
+}
+
+void wait_for_late_input() {
+    // Sleep for as much of the frame as the previous frames did not need, then poll the input again,
+    // so that the tick runs and its frame is submitted as close to the next present as possible
+    double frame_period = 1.0 / std::max(GetMonitorRefreshRate(GetCurrentMonitor()), 1);
+    double wake_up_at = last_present_time + frame_period - frame_work_estimate - LATE_INPUT_SAFETY_MARGIN;
+    double now = GetTime();
+    if (wake_up_at > now) {
+        WaitTime(wake_up_at - now);
+    }
+
+    PollInputEvents();
+    sample_input();
+}
+
+void begin_frame_timing() {
+    frame_work_started_at = GetTime();
+}
+
+void end_frame_timing() {
+    // Called after EndDrawing(); the work estimate excludes the time spent waiting for the present
+    double now = GetTime();
+    double frame_work = submit_started_at - frame_work_started_at;
+    frame_work_estimate += (frame_work - frame_work_estimate) * 0.1;
+    last_present_time = now;
+    trace_frame_presented();
+}
+
+void mark_frame_submitted() {
+    submit_started_at = GetTime();
+}
+
+#endif // LATENCY_H
@@ -2,10 +2,18 @@
 #include "player.h"
 #include "enemy.h"
 #include "globals.h"  // Still needed for game_state, timer, etc.
+#include "alloc_tracker.h"
+#include "world.h"
+#include "embedded_levels.h"
 #include <fstream>
 #include <vector>
 #include <stdexcept>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <thread>
 
 // This is level.cpp
 
@@ -14,8 +22,10 @@ Level* Level::instance = nullptr;
 
 Level::Level() :
     level_index(0),
+    load_count(0),
     LEVEL_COUNT(3),
-    current_level_data(nullptr)
+    level_arena("level", LEVEL_ARENA_BLOCK_SIZE),
+    has_spawn_point(false)
 {
     // Allocate memory for levels array
     levels = new level[LEVEL_COUNT];
@@ -40,44 +50,109 @@ bool Level::isInsideLevel(int row, int column) {
     return true;
 }
 
-bool Level::isColliding(Vector2 pos, char lookFor) {
-    Rectangle entityHitbox = {pos.x, pos.y, 1.0f, 1.0f};
+uint8_t Level::getTraitsAt(long row, long column) const {
+    // Out-of-bounds cells read as air, without branching
+    bool inside = row >= 0 && row < static_cast<long>(current_level.rows) &&
+                  column >= 0 && column < static_cast<long>(current_level.columns);
+    const char *chunk = inside ? getChunk(row / LEVEL_CHUNK_SIZE, column / LEVEL_CHUNK_SIZE) : nullptr;
+    char cell = chunk != nullptr ? chunk[(row % LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE + column % LEVEL_CHUNK_SIZE] : AIR;
+    return get_tile_traits(cell).flags;
+}
 
-    // Scan the adjacent area in the level to look for a match in collision
-    for (int row = pos.y - 1; row < pos.y + 1; ++row) {
-        for (int column = pos.x - 1; column < pos.x + 1; ++column) {
-            // Check if the cell is out-of-bounds
-            if (!isInsideLevel(row, column)) continue;
-            if (getLevelCell(row, column) == lookFor) {
-                Rectangle blockHitbox = {(float) column, (float) row, 1.0f, 1.0f};
-                if (CheckCollisionRecs(entityHitbox, blockHitbox)) {
-                    return true;
-                }
-            }
+uint8_t Level::getCollidingTraits(Vector2 pos) {
+    // A unit-sized hitbox overlaps at most a 2x2 block of cells: the one it starts in and, if it is not
+    // aligned to the grid, the next one
+    long rows[2] = { static_cast<long>(floorf(pos.y)), static_cast<long>(ceilf(pos.y)) };
+    long columns[2] = { static_cast<long>(floorf(pos.x)), static_cast<long>(ceilf(pos.x)) };
+
+    uint8_t traits = 0;
+    for (long row : rows) {
+        for (long column : columns) {
+            traits |= getTraitsAt(row, column);
         }
     }
-    return false;
+    return traits;
 }
 
-char& Level::getCollider(Vector2 pos, char lookFor) {
-    // Like isColliding(), except returns a reference to the colliding object
-    Rectangle playerHitbox = {pos.x, pos.y, 1.0f, 1.0f};
+sweep_result Level::sweepAxis(Vector2 pos, float delta, bool isVertical, uint8_t traits) const {
+    // Walks the lines of cells (columns or rows) the leading edge of the hitbox enters, in order,
+    // checking each one across the one or two cells the hitbox spans on the other axis
+    sweep_result result = {pos, false};
+    if (delta == 0.0f) return result;
+
+    float along = isVertical ? pos.y : pos.x;
+    float across = isVertical ? pos.x : pos.y;
+    long firstAcross = static_cast<long>(floorf(across));
+    long lastAcross = static_cast<long>(ceilf(across));
+    long lineCount = static_cast<long>(isVertical ? current_level.rows : current_level.columns);
+
+    bool isForward = delta > 0.0f;
+    long step = isForward ? 1 : -1;
+    long line = isForward ? static_cast<long>(floorf(along)) + 1 : static_cast<long>(ceilf(along)) - 1;
+    float target = along + delta;
+
+    // Past the level's edge there is nothing left to run into
+    while (isForward ? (line < target + 1.0f && line < lineCount) : (line + 1.0f > target && line >= 0)) {
+        uint8_t lineTraits = 0;
+        for (long cross = firstAcross; cross <= lastAcross; ++cross) {
+            lineTraits |= isVertical ? getTraitsAt(line, cross) : getTraitsAt(cross, line);
+        }
 
-    for (int row = pos.y - 1; row < pos.y + 1; ++row) {
-        for (int column = pos.x - 1; column < pos.x + 1; ++column) {
-            // Check if the cell is out-of-bounds
-            if (!isInsideLevel(row, column)) continue;
-            if (getLevelCell(row, column) == lookFor) {
-                Rectangle blockHitbox = {(float) column, (float) row, 1.0f, 1.0f};
-                if (CheckCollisionRecs(playerHitbox, blockHitbox)) {
-                    return getLevelCell(row, column);
-                }
-            }
+        if (lineTraits & traits) {
+            target = isForward ? static_cast<float>(line) - 1.0f : static_cast<float>(line) + 1.0f;
+            result.is_blocked = true;
+            break;
         }
+        line += step;
     }
 
-    // If failed, get an approximation
-    return getLevelCell(pos.x, pos.y);
+    (isVertical ? result.position.y : result.position.x) = target;
+    return result;
+}
+
+horizontal_span Level::findSpanWithTraits(Vector2 pos, uint8_t traits) const {
+    // The first columns with any of the traits on each side, across the one or two rows the hitbox spans;
+    // stretches where both rows are in unallocated chunks are all air, and are skipped a chunk at a time
+    long firstRow = static_cast<long>(floorf(pos.y));
+    long lastRow = static_cast<long>(ceilf(pos.y));
+    long columnCount = static_cast<long>(current_level.columns);
+
+    auto isAllAir = [&](long column) {
+        for (long row = firstRow; row <= lastRow; ++row) {
+            bool inside = row >= 0 && row < static_cast<long>(current_level.rows);
+            if (inside && getChunk(row / LEVEL_CHUNK_SIZE, column / LEVEL_CHUNK_SIZE) != nullptr) return false;
+        }
+        return true;
+    };
+    auto isBlocking = [&](long column) {
+        uint8_t columnTraits = 0;
+        for (long row = firstRow; row <= lastRow; ++row) {
+            columnTraits |= getTraitsAt(row, column);
+        }
+        return (columnTraits & traits) != 0;
+    };
+
+    horizontal_span span = {-INFINITY, INFINITY};
+    // Columns outside the level are air, so the search starts at its edge when the hitbox is past it
+    for (long column = std::min(static_cast<long>(ceilf(pos.x)) - 1, columnCount - 1); column >= 0; --column) {
+        if (isAllAir(column)) {
+            column -= column % static_cast<long>(LEVEL_CHUNK_SIZE);
+        }
+        else if (isBlocking(column)) {
+            span.left = static_cast<float>(column) + 1.0f;
+            break;
+        }
+    }
+    for (long column = std::max(static_cast<long>(floorf(pos.x)) + 1, 0L); column < columnCount; ++column) {
+        if (isAllAir(column)) {
+            column += LEVEL_CHUNK_SIZE - 1 - column % static_cast<long>(LEVEL_CHUNK_SIZE);
+        }
+        else if (isBlocking(column)) {
+            span.right = static_cast<float>(column) - 1.0f;
+            break;
+        }
+    }
+    return span;
 }
 
 void Level::resetLevelIndex() {
@@ -88,6 +163,10 @@ int Level::getLevelIndex() const {
     return level_index;
 }
 
+size_t Level::getLoadCount() const {
+    return load_count;
+}
+
 int Level::getLevelCount() const {
     return LEVEL_COUNT;
 }
@@ -96,166 +175,489 @@ const level& Level::getCurrentLevel() const {
     return current_level;
 }
 
+bool Level::hasSpawnPoint() const {
+    return has_spawn_point;
+}
+
+level_position Level::getSpawnPoint() const {
+    return spawn_point;
+}
+
+array_view<const level_position> Level::getEnemySpawns() const {
+    return {enemy_spawns.data, enemy_spawns.count};
+}
+
+array_view<const level_position> Level::getCoinPositions() const {
+    return {coin_positions.data, coin_positions.count};
+}
+
+array_view<const level_position> Level::getExitPositions() const {
+    return {exit_positions.data, exit_positions.count};
+}
+
+const Arena& Level::getArena() const {
+    return level_arena;
+}
+
 void Level::loadLevel(int offset) {
     level_index += offset;
 
     // Win logic
     if (level_index >= LEVEL_COUNT) {
         game_state = VICTORY_STATE;
-        create_victory_menu_background();
+        is_victory_background_stale = true;
         level_index = 0;
         return;
     }
 
-    loadLevelFromRLE("data/levels.rll");
+    loadLevelPack();
+}
+
+void Level::loadLevelPack() {
+#ifdef EMBED_LEVELS
+    // The level pack was built into the game and decoded when it was compiled
+    loadEmbeddedLevel();
+#else
+    loadLevelFromRLE(LEVEL_PACK_FILE);
+#endif
+}
+
+// The entity arrays the decoder fills in, each row writing to its own slice of them
+struct entity_arrays {
+    array_view<level_position> enemies, coins, exits;
+};
+
+// Reads the run starting at `i`, which must have been validated by Level::scanEncodedLevel(), and moves past it
+static size_t read_run(std::string_view content, size_t& i, char& element) {
+    size_t count = 1;
+    if (isdigit(static_cast<unsigned char>(content[i]))) {
+        count = 0;
+        while (isdigit(static_cast<unsigned char>(content[i]))) {
+            count = count * 10 + (content[i++] - '0');
+        }
+    }
+    element = content[i++];
+    return count;
+}
+
+// Writes a run into the chunks it covers, all of which must have been allocated unless the run is air
+static void fill_run(const level& grid, size_t row, size_t column, size_t count, char element) {
+    // Allocated chunks start out as air, so runs of air (including the padding of short rows) are already there
+    if (element == AIR) return;
+
+    char** chunkRow = grid.chunks + (row / LEVEL_CHUNK_SIZE) * grid.chunk_columns;
+    size_t rowOffset = (row % LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE;
+    while (count > 0) {
+        size_t columnInChunk = column % LEVEL_CHUNK_SIZE;
+        size_t length = std::min(count, LEVEL_CHUNK_SIZE - columnInChunk);
+        std::memset(chunkRow[column / LEVEL_CHUNK_SIZE] + rowOffset + columnInChunk, element, length);
+        column += length;
+        count -= length;
+    }
+}
+
+// Expands the runs of the given rows straight into the level grid, and writes down where the entities are.
+// The rows must have been validated by Level::scanEncodedLevel(), and their chunks allocated.
+static void decode_rows(
+    std::string_view content,
+    const encoded_level& encoded,
+    size_t first, size_t last,
+    const level& grid,
+    const entity_arrays& entities
+) {
+    for (size_t row = first; row < last; ++row) {
+        const encoded_row& encodedRow = encoded.rows[row];
+        size_t column = 0;
+        size_t enemy = encodedRow.first_enemy;
+        size_t coin = encodedRow.first_coin;
+        size_t exit = encodedRow.first_exit;
+        size_t i = encodedRow.begin;
+
+        while (i < encodedRow.end) {
+            char element;
+            size_t count = read_run(content, i, element);
+
+            bool isEnemy = element == ENEMY || element == CHASER;
+            for (size_t j = 0; j < count && (isEnemy || element == COIN || element == EXIT); ++j) {
+                level_position position = {row, column + j};
+                if (isEnemy) entities.enemies[enemy++] = position;
+                else if (element == COIN) entities.coins[coin++] = position;
+                else entities.exits[exit++] = position;
+            }
+
+            fill_run(grid, row, column, count, element);
+            column += count;
+        }
+    }
+}
+
+static bool is_level_element(char c) {
+    return get_tile_traits(c).is_level_element;
+}
+
+encoded_level Level::scanEncodedLevel(std::string_view content, const std::string& filename, size_t lineNumber) {
+    auto malformed = [&](size_t column, const std::string& reason) {
+        std::string message = filename + ":" + std::to_string(lineNumber) + ":" + std::to_string(column + 1) +
+                              ": malformed level, " + reason;
+        TraceLog(LOG_ERROR, "%s", message.c_str());
+        return std::runtime_error(message);
+    };
+
+    // There can be no more rows than pipes, plus one
+    encoded_level encoded;
+    encoded.rows = level_arena.allocateArray<encoded_row>(std::count(content.begin(), content.end(), '|') + 1);
+    size_t rowCount = 0;
+
+    has_spawn_point = false;
+
+    encoded_row row;
+    size_t i = 0;
+    bool terminated = false;
+
+    while (i < content.length()) {
+        // Rows are separated by pipes, and a period ends the level
+        if (content[i] == '|' || content[i] == '.') {
+            terminated = content[i] == '.';
+            row.end = i;
+            if (!terminated || row.end > row.begin) {
+                encoded.rows[rowCount++] = row;
+                encoded.columns = std::max(encoded.columns, row.length);
+            }
+            if (terminated) {
+                break;
+            }
+
+            row = {i + 1, i + 1, 0, encoded.enemy_count, encoded.coin_count, encoded.exit_count};
+            ++i;
+            continue;
+        }
+
+        // Parse the number for repetition count, if any
+        size_t runStart = i;
+        size_t count = 1;
+        if (isdigit(static_cast<unsigned char>(content[i]))) {
+            count = 0;
+            while (i < content.length() && isdigit(static_cast<unsigned char>(content[i]))) {
+                if (count > (MAX_RUN_LENGTH - 9) / 10) {
+                    throw malformed(runStart, "run length is too large");
+                }
+                count = count * 10 + (content[i++] - '0');
+            }
+            if (i == content.length() || content[i] == '|' || content[i] == '.') {
+                throw malformed(runStart, "run length is not followed by a level element");
+            }
+            if (count == 0) {
+                throw malformed(runStart, "run length must be positive");
+            }
+        }
+
+        char element = content[i];
+        if (!is_level_element(element)) {
+            throw malformed(i, std::string("unknown level element '") + element + "'");
+        }
+
+        // Only count the entities here; the decoder writes down their positions while it expands the runs
+        switch (element) {
+            case PLAYER:
+                // The first marker is the spawn point, as when the player used to search the grid for it
+                if (!has_spawn_point) {
+                    has_spawn_point = true;
+                    spawn_point = {rowCount, row.length};
+                }
+                break;
+            case ENEMY:
+            case CHASER:
+                encoded.enemy_count += count;
+                break;
+            case COIN:
+                encoded.coin_count += count;
+                break;
+            case EXIT:
+                encoded.exit_count += count;
+                break;
+            default:
+                break;
+        }
+
+        row.length += count;
+        ++i;
+    }
+
+    // If we reached the end without a period, add the last part
+    if (!terminated && content.length() > row.begin) {
+        row.end = content.length();
+        encoded.rows[rowCount++] = row;
+        encoded.columns = std::max(encoded.columns, row.length);
+    }
 
+    encoded.rows.count = rowCount;
+    return encoded;
 }
 
 void Level::loadLevelFromRLE(const std::string& filename) {
-    std::ifstream file(filename);
+    AllocationTracker::Zone allocationZone(LEVEL_LOAD_ZONE);
+
+    // Release the previous level in one go; everything this level needs comes from the arena
+    unloadLevel();
+
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         TraceLog(LOG_ERROR, "Failed to open file: %s", filename.c_str());
         throw std::runtime_error("Failed to open file: " + filename);
     }
 
-    std::string line;
-    std::vector<std::string> levelStrings;
+    file.seekg(0, std::ios::end);
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    array_view<char> fileData = level_arena.allocateArray<char>(fileSize);
+    file.read(fileData.data, static_cast<std::streamsize>(fileSize));
+
+    // Find the level at the current index, skipping comments (lines starting with semicolon) and empty lines
+    std::string_view fileContent(fileData.data, fileSize);
+    std::string_view content;
+    size_t lineNumber = 0;
+    size_t contentLineNumber = 0;
+    int levelCount = 0;
+
+    for (size_t lineStart = 0; lineStart < fileContent.length();) {
+        size_t lineEnd = fileContent.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = fileContent.length();
+        }
+        std::string_view line = fileContent.substr(lineStart, lineEnd - lineStart);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        ++lineNumber;
+        lineStart = lineEnd + 1;
 
-    // Read all levels from the file
-    while (std::getline(file, line)) {
-        // Skip comments (lines starting with semicolon)
         if (line.empty() || line[0] == ';') {
             continue;
         }
-        levelStrings.push_back(line);
+        if (levelCount == level_index || levelCount == 0) {
+            content = line;
+            contentLineNumber = lineNumber;
+        }
+        ++levelCount;
     }
 
-    TraceLog(LOG_INFO, "Found %d levels in %s", levelStrings.size(), filename.c_str());
+    TraceLog(LOG_INFO, "Found %d levels in %s", levelCount, filename.c_str());
 
     // Make sure we have enough levels
-    if (levelStrings.empty()) {
+    if (levelCount == 0) {
         TraceLog(LOG_ERROR, "No valid levels found in file");
         throw std::runtime_error("No valid levels found in file");
     }
 
-    if (level_index >= levelStrings.size()) {
-        TraceLog(LOG_ERROR, "Level index %d is out of range (max %d)", level_index, levelStrings.size() - 1);
+    if (level_index >= levelCount) {
+        TraceLog(LOG_ERROR, "Level index %d is out of range (max %d)", level_index, levelCount - 1);
         level_index = 0; // Reset to first level instead of throwing
     }
 
-    // Use the level at the current index
-    std::string content = levelStrings[level_index];
     TraceLog(LOG_INFO, "Loading level %d, content length: %d", level_index, content.length());
 
-    // COMPLETELY REWRITTEN PARSING LOGIC
-    std::vector<std::string> rows;
-    size_t start = 0;
-    size_t pos = 0;
-
-    // Split by pipes
-    while (pos < content.length()) {
-        if (content[pos] == '|') {
-            // Add everything from start to pos
-            rows.push_back(content.substr(start, pos - start));
-            start = pos + 1;  // Skip the pipe
-        } else if (content[pos] == '.') {
-            // Add the last part before the period
-            if (pos > start) {
-                rows.push_back(content.substr(start, pos - start));
-            }
-            break;  // End of level
+    auto decodeStart = std::chrono::steady_clock::now();
+
+    // Pre-scan: locate the rows, validate them, measure their decoded lengths, and count the entities
+    encoded_level encoded = scanEncodedLevel(content, filename, contentLineNumber);
+    size_t numRows = encoded.rows.size();
+    size_t maxCols = encoded.columns;
+
+    TraceLog(LOG_INFO, "Found %d rows in level", numRows);
+    TraceLog(LOG_INFO, "Level dimensions: %d rows x %d columns", numRows, maxCols);
+    TraceLog(LOG_INFO, "Level entities: %d enemies, %d coins, %d exits",
+             encoded.enemy_count, encoded.coin_count, encoded.exit_count);
+
+    // Allocate the chunks that are not all air and the entity arrays once, and expand the runs straight into them
+    size_t cellCount = numRows * maxCols;
+    current_level = {numRows, maxCols};
+    current_level.chunk_rows = (numRows + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+    current_level.chunk_columns = (maxCols + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+    size_t chunkCount = allocateNonEmptyChunks(content, encoded);
+    enemy_spawns = level_arena.allocateArray<level_position>(encoded.enemy_count);
+    coin_positions = level_arena.allocateArray<level_position>(encoded.coin_count);
+    exit_positions = level_arena.allocateArray<level_position>(encoded.exit_count);
+    entity_arrays entities = {enemy_spawns, coin_positions, exit_positions};
+
+    size_t threadCount = std::min<size_t>(std::thread::hardware_concurrency(), numRows);
+    if (cellCount >= PARALLEL_DECODE_MIN_CELLS && threadCount > 1) {
+        // Very large levels are split into bands of rows decoded in parallel
+        std::vector<std::thread> workers;
+        // Bands are made of whole chunk rows, so that no chunk is written to by two threads
+        size_t rowsPerThread = (numRows + threadCount - 1) / threadCount;
+        rowsPerThread = (rowsPerThread + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE * LEVEL_CHUNK_SIZE;
+        for (size_t first = 0; first < numRows; first += rowsPerThread) {
+            size_t last = std::min(first + rowsPerThread, numRows);
+            workers.emplace_back(decode_rows, content, std::cref(encoded), first, last, std::cref(current_level), std::cref(entities));
+        }
+        for (auto& worker : workers) {
+            worker.join();
         }
-        pos++;
     }
-
-    // If we reached the end without a period, add the last part
-    if (pos == content.length() && pos > start) {
-        rows.push_back(content.substr(start));
+    else {
+        decode_rows(content, encoded, 0, numRows, current_level, entities);
     }
 
-    TraceLog(LOG_INFO, "Found %d rows in level", rows.size());
-
-    // Decode RLE
-    std::vector<std::string> decodedRows;
-    for (const auto& row : rows) {
-        std::string decodedRow;
-        size_t i = 0;
-
-        while (i < row.length()) {
-            // If it's a digit, we need to parse a number
-            if (isdigit(row[i])) {
-                // Parse the number for repetition count
-                int count = 0;
-                while (i < row.length() && isdigit(row[i])) {
-                    count = count * 10 + (row[i] - '0');
-                    i++;
-                }
+    std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - decodeStart;
+    double seconds = std::max(decodeTime.count(), 1e-9);
+    TraceLog(LOG_INFO, "Decoded %zu bytes into %zu cells in %.3f ms (%.3f GB/s)",
+             content.length(), cellCount, seconds * 1e3, static_cast<double>(cellCount) / seconds / 1e9);
+    TraceLog(LOG_INFO, "Level grid: %zu of %zu chunks allocated, the others are all air",
+             chunkCount, current_level.chunk_rows * current_level.chunk_columns);
+    level_arena.logStats();
 
-                // Ensure we haven't reached the end
-                if (i < row.length()) {
-                    // Get the character to repeat
-                    char c = row[i++];
-                    // Repeat the character 'count' times
-                    for (int j = 0; j < count; j++) {
-                        decodedRow += c;
-                    }
-                }
-            }
-            // If not a digit, just add the character as-is
-            else {
-                decodedRow += row[i++];
-            }
-        }
+    finishLoading();
+}
 
-        decodedRows.push_back(decodedRow);
+void Level::loadEmbeddedLevel() {
+#ifdef EMBED_LEVELS
+    AllocationTracker::Zone allocationZone(LEVEL_LOAD_ZONE);
+    unloadLevel();
+
+    if (level_index >= static_cast<int>(EMBEDDED_LEVELS.level_count)) {
+        TraceLog(LOG_ERROR, "Level index %d is out of range (max %d)", level_index,
+                 static_cast<int>(EMBEDDED_LEVELS.level_count) - 1);
+        level_index = 0;
+    }
+    const embedded_level_info& info = EMBEDDED_LEVELS.levels[level_index];
+
+    // Everything was decoded at compile time, so the chunks and entities only have to be copied into the arena,
+    // where the game may change them
+    current_level = {info.rows, info.columns};
+    current_level.chunk_rows = (info.rows + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+    current_level.chunk_columns = (info.columns + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+    size_t directorySize = current_level.chunk_rows * current_level.chunk_columns;
+    current_level.chunks = level_arena.allocateArray<char*>(directorySize).data;
+    std::fill(current_level.chunks, current_level.chunks + directorySize, nullptr);
+    for (size_t i = 0; i < info.chunk_count; ++i) {
+        const embedded_chunk& chunk = EMBEDDED_LEVELS.chunks[info.first_chunk + i];
+        char* cells = level_arena.allocateArray<char>(LEVEL_CHUNK_CELLS).data;
+        std::memcpy(cells, chunk.cells, LEVEL_CHUNK_CELLS);
+        current_level.chunks[chunk.index] = cells;
     }
 
-    // Create level
-    size_t numRows = decodedRows.size();
-    size_t maxCols = 0;
+    auto copyEntities = [this](const level_position* first, size_t count) {
+        array_view<level_position> entities = level_arena.allocateArray<level_position>(count);
+        std::copy(first, first + count, entities.data);
+        return entities;
+    };
+    enemy_spawns = copyEntities(EMBEDDED_LEVELS.enemies + info.first_enemy, info.enemy_count);
+    coin_positions = copyEntities(EMBEDDED_LEVELS.coins + info.first_coin, info.coin_count);
+    exit_positions = copyEntities(EMBEDDED_LEVELS.exits + info.first_exit, info.exit_count);
+    has_spawn_point = info.has_spawn_point;
+    spawn_point = info.spawn_point;
+
+    TraceLog(LOG_INFO, "Loaded embedded level %d: %zu rows x %zu columns, %zu of %zu chunks", level_index,
+             info.rows, info.columns, info.chunk_count, directorySize);
+
+    finishLoading();
+#endif
+}
 
-    // Find the maximum column count
-    for (const auto& row : decodedRows) {
-        maxCols = std::max(maxCols, row.length());
-    }
+void Level::finishLoading() {
+    // Setup entities and game state
+    Player::getInstance()->spawn();
+    Enemy::spawnAll();
+    spawnPickups();
 
-    TraceLog(LOG_INFO, "Level dimensions: %d rows x %d columns", numRows, maxCols);
+    // The graphics are rebuilt by the main thread before the next frame is drawn
+    is_level_graphics_stale = true;
+    ++load_count;
+    timer = MAX_LEVEL_TIME;
+}
+
+char* Level::allocateChunk() {
+    char* chunk = level_arena.allocateArray<char>(LEVEL_CHUNK_SIZE * LEVEL_CHUNK_SIZE).data;
+    std::memset(chunk, AIR, LEVEL_CHUNK_SIZE * LEVEL_CHUNK_SIZE);
+    return chunk;
+}
 
-    // Allocate memory for level data
-    delete[] current_level_data; // Clear previous data if any
-    current_level_data = new char[numRows * maxCols];
-
-    // Fill the level data
-    for (size_t row = 0; row < numRows; row++) {
-        for (size_t col = 0; col < maxCols; col++) {
-            if (col < decodedRows[row].length()) {
-                current_level_data[row * maxCols + col] = decodedRows[row][col];
-            } else {
-                // Fill with air if the row is shorter than maxCols
-                current_level_data[row * maxCols + col] = AIR;
+size_t Level::allocateNonEmptyChunks(std::string_view content, const encoded_level& encoded) {
+    // A second look at the runs, now that the level's size is known: only the chunks some run
+    // of anything but air passes through are allocated
+    size_t directorySize = current_level.chunk_rows * current_level.chunk_columns;
+    current_level.chunks = level_arena.allocateArray<char*>(directorySize).data;
+    std::fill(current_level.chunks, current_level.chunks + directorySize, nullptr);
+
+    size_t chunkCount = 0;
+    for (size_t row = 0; row < encoded.rows.size(); ++row) {
+        char** chunkRow = current_level.chunks + (row / LEVEL_CHUNK_SIZE) * current_level.chunk_columns;
+        size_t column = 0;
+        size_t i = encoded.rows[row].begin;
+        while (i < encoded.rows[row].end) {
+            char element;
+            size_t count = read_run(content, i, element);
+            if (element != AIR) {
+                size_t lastChunk = (column + count - 1) / LEVEL_CHUNK_SIZE;
+                for (size_t chunk = column / LEVEL_CHUNK_SIZE; chunk <= lastChunk; ++chunk) {
+                    if (chunkRow[chunk] == nullptr) {
+                        chunkRow[chunk] = allocateChunk();
+                        ++chunkCount;
+                    }
+                }
             }
+            column += count;
         }
     }
+    return chunkCount;
+}
 
-    // Update current level structure
-    current_level = {numRows, maxCols, current_level_data};
+void Level::spawnPickups() {
+    // Coins become entities, so that they are picked up and drawn like everything else that isn't a tile
+    World* world = World::getInstance();
+    world->destroyAll(PICKUP_COMPONENT);
 
-    // Setup entities and game state
-    Player::getInstance()->spawn();
-    Enemy::spawnAll();
-    derive_graphics_metrics_from_loaded_level();
-    timer = MAX_LEVEL_TIME;
+    for (const auto &coin : coin_positions) {
+        entity_id pickup = world->create(PICKUP_COMPONENT | POSITION_COMPONENT | ANIMATION_COMPONENT);
+        world->getPosition(pickup) = {static_cast<float>(coin.column), static_cast<float>(coin.row)};
+        world->getAnimation(pickup).source = &coin_sprite;
+        setLevelCell(coin.row, coin.column, AIR);
+    }
 }
 
 void Level::unloadLevel() {
-    delete[] current_level_data;
-    current_level_data = nullptr;
+    // Everything the level owned came from its arena, so this is O(1)
+    level_arena.reset();
+    current_level = {};
+    has_spawn_point = false;
+    enemy_spawns = {};
+    coin_positions = {};
+    exit_positions = {};
+}
+
+char Level::getLevelCell(size_t row, size_t column) const {
+    const char* chunk = getChunk(row / LEVEL_CHUNK_SIZE, column / LEVEL_CHUNK_SIZE);
+    return chunk != nullptr ? chunk[(row % LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE + column % LEVEL_CHUNK_SIZE] : AIR;
 }
 
-char& Level::getLevelCell(size_t row, size_t column) {
-    return current_level.data[row * current_level.columns + column];
+const char* Level::getChunk(size_t chunkRow, size_t chunkColumn) const {
+    return current_level.chunks[chunkRow * current_level.chunk_columns + chunkColumn];
 }
 
 void Level::setLevelCell(size_t row, size_t column, char chr) {
-    getLevelCell(row, column) = chr;
+    char cell = getLevelCell(row, column);
+
+    // Walls, dark walls, and spikes are drawn from a cache that has to be rebuilt when they change
+    if (cell != chr && (isStaticTile(cell) || isStaticTile(chr))) {
+        invalidate_static_tile_column(column);
+    }
+
+    // Chasers find their way around walls, so they need a new path when one appears or disappears
+    if (has_tile_traits(cell, SOLID_TILE) != has_tile_traits(chr, SOLID_TILE)) {
+        Enemy::invalidateChaseField();
+        Enemy::invalidatePatrolSpans(row);
+    }
+
+    // A chunk is only allocated once something other than air is put into it
+    char*& chunk = current_level.chunks[(row / LEVEL_CHUNK_SIZE) * current_level.chunk_columns + column / LEVEL_CHUNK_SIZE];
+    if (chunk == nullptr) {
+        if (chr == AIR) return;
+        chunk = allocateChunk();
+    }
+    chunk[(row % LEVEL_CHUNK_SIZE) * LEVEL_CHUNK_SIZE + column % LEVEL_CHUNK_SIZE] = chr;
+}
+
+bool Level::isStaticTile(char cell) {
+    return has_tile_traits(cell, DRAWABLE_TILE);
 }
\ No newline at end of file
@@ -3,21 +3,81 @@
 
 // This is level.h
 #include "raylib.h"
+#include "arena.h"
+#include "tiles.h"
 #include <string>
+#include <string_view>
 
+// The grid is split into LEVEL_CHUNK_SIZE x LEVEL_CHUNK_SIZE chunks, listed row by row in a directory;
+// chunks that are all air are never allocated, and their entry in the directory is null
 struct level {
     size_t rows = 0, columns = 0;
-    char *data = nullptr;
+    size_t chunk_rows = 0, chunk_columns = 0;
+    char **chunks = nullptr;
+};
+
+struct level_position {
+    size_t row = 0, column = 0;
+};
+
+// A row of an RLE-encoded level: where its runs are in the encoded string, how long it is once decoded,
+// and where its entities go in the level's entity arrays
+struct encoded_row {
+    size_t begin = 0, end = 0;
+    size_t length = 0;
+    size_t first_enemy = 0, first_coin = 0, first_exit = 0;
+};
+
+// What the pre-scan of an RLE-encoded level found out about it
+struct encoded_level {
+    array_view<encoded_row> rows;
+    size_t columns = 0;
+    size_t enemy_count = 0, coin_count = 0, exit_count = 0;
+};
+
+// Where a hitbox swept along one axis stops, and whether something stopped it before it got all the way
+struct sweep_result {
+    Vector2 position = {0.0f, 0.0f};
+    bool is_blocked = false;
+};
+
+// The stretch a unit-sized hitbox can move along horizontally before it runs into a tile on either side;
+// the bounds are infinite on the sides where it could leave the level instead
+struct horizontal_span {
+    float left = 0.0f, right = 0.0f;
 };
 
 class Level {
     static Level* instance;
 
     int level_index;
+    size_t load_count; // Levels loaded so far, including reloads of the same one
     const int LEVEL_COUNT;
     level* levels;
     level current_level;
-    char* current_level_data;
+
+    // Owns everything that lives as long as the current level: the grid, the entity arrays, and the decode buffers
+    Arena level_arena;
+
+    // Entities found while decoding the current level
+    bool has_spawn_point;
+    level_position spawn_point;
+    array_view<level_position> enemy_spawns;
+    array_view<level_position> coin_positions;
+    array_view<level_position> exit_positions;
+
+    uint8_t getTraitsAt(long row, long column) const;
+    sweep_result sweepAxis(Vector2 pos, float delta, bool isVertical, uint8_t traits) const;
+    horizontal_span findSpanWithTraits(Vector2 pos, uint8_t traits) const;
+
+    void spawnPickups();
+
+    char* allocateChunk();
+    size_t allocateNonEmptyChunks(std::string_view content, const encoded_level& encoded);
+
+    encoded_level scanEncodedLevel(std::string_view content, const std::string& filename, size_t lineNumber);
+    void loadEmbeddedLevel();
+    void finishLoading();
 
     // Private constructor for singleton pattern
     Level();
@@ -31,8 +91,32 @@ public:
 
     // Level methods
     bool isInsideLevel(int row, int column);
-    bool isColliding(Vector2 pos, char lookFor = '#');
-    char& getCollider(Vector2 pos, char lookFor);
+
+    // Collision queries: the traits of all the tiles a unit-sized hitbox at `pos` overlaps, OR'ed together
+    uint8_t getCollidingTraits(Vector2 pos);
+
+    template <uint8_t TRAITS>
+    bool isColliding(Vector2 pos) {
+        return (getCollidingTraits(pos) & TRAITS) != 0;
+    }
+
+    // Swept collision: moves a unit-sized hitbox by `delta` cells and stops it right before the first tile
+    // with any of the traits, however far it goes in one step
+    template <uint8_t TRAITS>
+    sweep_result sweepHorizontally(Vector2 pos, float delta) const {
+        return sweepAxis(pos, delta, false, TRAITS);
+    }
+
+    template <uint8_t TRAITS>
+    sweep_result sweepVertically(Vector2 pos, float delta) const {
+        return sweepAxis(pos, delta, true, TRAITS);
+    }
+
+    // Where sweepHorizontally() would stop the hitbox on either side, from anywhere between the two bounds
+    template <uint8_t TRAITS>
+    horizontal_span findHorizontalSpan(Vector2 pos) const {
+        return findSpanWithTraits(pos, TRAITS);
+    }
 
     // Level management
     void resetLevelIndex();
@@ -40,16 +124,29 @@ public:
     void unloadLevel();
 
     // Cell access
-    char& getLevelCell(size_t row, size_t column);
+    char getLevelCell(size_t row, size_t column) const;
     void setLevelCell(size_t row, size_t column, char chr);
+    const char* getChunk(size_t chunkRow, size_t chunkColumn) const;
+    static bool isStaticTile(char cell);
 
     // Level RLE loading
+    void loadLevelPack();
     void loadLevelFromRLE(const std::string& filename);
 
     // Getters for previously global variables
     int getLevelIndex() const;
+    size_t getLoadCount() const;
     int getLevelCount() const;
     const level& getCurrentLevel() const;
+
+    // Entities of the current level, collected while decoding
+    bool hasSpawnPoint() const;
+    level_position getSpawnPoint() const;
+    array_view<const level_position> getEnemySpawns() const;
+    array_view<const level_position> getCoinPositions() const;
+    array_view<const level_position> getExitPositions() const;
+
+    const Arena& getArena() const;
 };
 
 #endif // LEVEL_H
\ No newline at end of file
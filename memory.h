@@ -0,0 +1,177 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+// This is memory.h
+#include "raylib.h"
+#include "globals.h"
+#include "level.h"
+#include "enemy.h"
+#include "world.h"
+
+#include <algorithm>
+
+size_t estimate_texture_bytes(Texture2D texture) {
+    // Every mipmap level is half as wide and tall as the one before it
+    size_t bytes = 0;
+    for (int level = 0; level < std::max(texture.mipmaps, 1); ++level) {
+        int width = std::max(texture.width >> level, 1);
+        int height = std::max(texture.height >> level, 1);
+        bytes += GetPixelDataSize(width, height, texture.format);
+    }
+    return bytes;
+}
+
+size_t estimate_render_texture_bytes(RenderTexture2D target) {
+    // The depth attachment is a 24-bit renderbuffer, which drivers store in 32 bits
+    size_t depth_bytes = target.depth.id != 0 ? static_cast<size_t>(target.depth.width) * target.depth.height * 4 : 0;
+    return target.id != 0 ? estimate_texture_bytes(target.texture) + depth_bytes : 0;
+}
+
+size_t estimate_sound_bytes(Sound sound) {
+    // Sounds are fully decoded when loaded; their aliases share the samples
+    return static_cast<size_t>(sound.frameCount) * sound.stream.channels * sound.stream.sampleSize / 8;
+}
+
+memory_usage estimate_font_memory(const Font &font) {
+    // Glyph images are only kept when the atlas was generated rather than loaded from the cache
+    memory_usage usage;
+    usage.gpu_bytes = estimate_texture_bytes(font.texture);
+    usage.cpu_bytes = font.glyphCount * (sizeof(GlyphInfo) + sizeof(Rectangle));
+    for (int i = 0; i < font.glyphCount; ++i) {
+        const Image &image = font.glyphs[i].image;
+        if (image.data != nullptr) {
+            usage.cpu_bytes += GetPixelDataSize(image.width, image.height, image.format);
+        }
+    }
+    return usage;
+}
+
+void add_memory_usage(memory_usage &total, memory_usage usage) {
+    total.cpu_bytes += usage.cpu_bytes;
+    total.gpu_bytes += usage.gpu_bytes;
+}
+
+void subtract_memory_usage(memory_usage &total, memory_usage usage) {
+    total.cpu_bytes -= usage.cpu_bytes;
+    total.gpu_bytes -= usage.gpu_bytes;
+}
+
+memory_usage measure_image_memory() {
+    return loaded_image_memory;
+}
+
+memory_usage measure_font_memory() {
+    return loaded_font_memory;
+}
+
+memory_usage measure_sound_memory() {
+    return loaded_sound_memory;
+}
+
+memory_usage measure_render_target_memory() {
+    memory_usage usage;
+    usage.gpu_bytes = estimate_render_texture_bytes(scene_target) + estimate_render_texture_bytes(composed_background_target);
+    for (const auto &chunk : static_tile_chunks) {
+        usage.gpu_bytes += estimate_render_texture_bytes(chunk.target);
+    }
+    usage.cpu_bytes = static_tile_chunks.capacity() * sizeof(static_tile_chunk);
+    return usage;
+}
+
+memory_usage measure_level_memory() {
+    // The grid, the entity arrays, and the decode buffers all live in the level arena
+    memory_usage usage;
+    usage.cpu_bytes = Level::getInstance()->getArena().getStats().capacity_bytes;
+    return usage;
+}
+
+memory_usage measure_entity_memory() {
+    memory_usage usage;
+    usage.cpu_bytes = World::getInstance()->getStorageBytes() + Enemy::getChaseField().getStorageBytes();
+    return usage;
+}
+
+memory_usage measure_frame_memory() {
+    // Scratch memory reused every frame: the frame arena, the draw list, and the render snapshot
+    memory_usage usage;
+    usage.cpu_bytes = frame_arena.getStats().capacity_bytes +
+                      draw_list.capacity() * sizeof(draw_command) +
+                      (render_snapshot.items.capacity() + render_snapshot.enemies.capacity()) * sizeof(snapshot_image);
+    return usage;
+}
+
+void add_memory_account(const char *name, memory_usage (*measure)()) {
+    if (memory_account_count == MAX_MEMORY_ACCOUNTS) {
+        TraceLog(LOG_ERROR, "Too many memory accounts, %s is not accounted for", name);
+        return;
+    }
+
+    memory_account &account = memory_accounts[memory_account_count++];
+    account.name = name;
+    account.measure = measure;
+}
+
+void register_memory_accounts() {
+    add_memory_account("Images", measure_image_memory);
+    add_memory_account("Fonts", measure_font_memory);
+    add_memory_account("Sounds", measure_sound_memory);
+    add_memory_account("Render targets", measure_render_target_memory);
+    add_memory_account("Level", measure_level_memory);
+    add_memory_account("Entities", measure_entity_memory);
+    add_memory_account("Frame scratch", measure_frame_memory);
+}
+
+void raise_high_water(memory_usage &high_water, memory_usage usage) {
+    high_water.cpu_bytes = std::max(high_water.cpu_bytes, usage.cpu_bytes);
+    high_water.gpu_bytes = std::max(high_water.gpu_bytes, usage.gpu_bytes);
+}
+
+void report_level_memory_peak() {
+    // The sum of every account's peak, which is at least the peak of their sum
+    memory_usage peak;
+    for (size_t i = 0; i < memory_account_count; ++i) {
+        peak.cpu_bytes += memory_accounts[i].level_high_water.cpu_bytes;
+        peak.gpu_bytes += memory_accounts[i].level_high_water.gpu_bytes;
+    }
+    TraceLog(LOG_INFO, "MEMORY: level %d peaked at %zu KiB CPU, %zu KiB GPU",
+             memory_accounted_level_index + 1, peak.cpu_bytes / 1024, peak.gpu_bytes / 1024);
+}
+
+void update_memory_accounts() {
+    // Called once a frame between two ticks, as measuring reads the level and the world
+    Level* level = Level::getInstance();
+    bool is_new_level = level->getLoadCount() != memory_accounted_level_load;
+    if (is_new_level && memory_accounted_level_load != 0) {
+        report_level_memory_peak();
+    }
+    memory_accounted_level_load = level->getLoadCount();
+    memory_accounted_level_index = level->getLevelIndex();
+
+    memory_total = {};
+    for (size_t i = 0; i < memory_account_count; ++i) {
+        memory_account &account = memory_accounts[i];
+        account.current = account.measure();
+        if (is_new_level) {
+            account.level_high_water = {};
+        }
+        raise_high_water(account.level_high_water, account.current);
+        raise_high_water(account.high_water, account.current);
+
+        memory_total.cpu_bytes += account.current.cpu_bytes;
+        memory_total.gpu_bytes += account.current.gpu_bytes;
+    }
+}
+
+void report_memory_accounts() {
+    TraceLog(LOG_INFO, "MEMORY: %-16s %12s %12s %12s %12s", "", "CPU KiB", "GPU KiB", "peak CPU", "peak GPU");
+    for (size_t i = 0; i < memory_account_count; ++i) {
+        const memory_account &account = memory_accounts[i];
+        TraceLog(LOG_INFO, "MEMORY: %-16s %12zu %12zu %12zu %12zu", account.name,
+                 account.current.cpu_bytes / 1024, account.current.gpu_bytes / 1024,
+                 account.high_water.cpu_bytes / 1024, account.high_water.gpu_bytes / 1024);
+    }
+    TraceLog(LOG_INFO, "MEMORY: %-16s %12zu %12zu", "Total", memory_total.cpu_bytes / 1024, memory_total.gpu_bytes / 1024);
+    report_level_memory_peak();
+}
+
+#endif // MEMORY_H
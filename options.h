@@ -0,0 +1,70 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+// This is options.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <cstring>
+
+void parse_launch_options(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char *option = argv[i];
+        if (std::strcmp(option, "--trace-latency") == 0) {
+            launch_options.trace_latency = true;
+        }
+        else if (std::strcmp(option, "--late-input") == 0) {
+            launch_options.late_input = true;
+        }
+        else if (std::strcmp(option, "--no-vsync") == 0) {
+            launch_options.vsync = false;
+        }
+        else if (std::strcmp(option, "--low-res") == 0) {
+            launch_options.low_res_scene = true;
+        }
+        else if (std::strcmp(option, "--pipelined") == 0) {
+            launch_options.pipelined = true;
+        }
+        else if (std::strcmp(option, "--poll-input") == 0) {
+            // The polling paces the frames, so waiting for the vertical blank would only make them miss it
+            launch_options.poll_input = true;
+            launch_options.vsync = false;
+        }
+        else if (std::strcmp(option, "--fixed-quality") == 0) {
+            launch_options.fixed_quality = true;
+        }
+        else if (std::strcmp(option, "--capture") == 0 && i + 1 < argc) {
+            launch_options.capture_directory = argv[++i];
+        }
+        else if (std::strcmp(option, "--capture-pipe") == 0 && i + 1 < argc) {
+            launch_options.capture_command = argv[++i];
+        }
+        else if (std::strcmp(option, "--alloc-test") == 0) {
+            launch_options.alloc_test = true;
+            launch_options.vsync = false;
+        }
+        else {
+            TraceLog(LOG_WARNING, "Unknown option: %s", option);
+        }
+    }
+
+    // The allocation test scripts its input, so there is no keyboard to poll, and it has to draw the same
+    // things however fast the machine running it is
+    if (launch_options.alloc_test) {
+        launch_options.poll_input = false;
+        launch_options.fixed_quality = true;
+    }
+
+    // Capturing reads every frame into a new image, which the allocation test would count
+    if (launch_options.alloc_test && (launch_options.capture_directory || launch_options.capture_command)) {
+        TraceLog(LOG_WARNING, "Frames are not captured during the allocation test");
+        launch_options.capture_directory = nullptr;
+        launch_options.capture_command = nullptr;
+    }
+    if (launch_options.capture_directory && launch_options.capture_command) {
+        TraceLog(LOG_WARNING, "Both --capture and --capture-pipe given, only piping");
+        launch_options.capture_directory = nullptr;
+    }
+}
+
+#endif // OPTIONS_H
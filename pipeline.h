@@ -0,0 +1,139 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+// This is pipeline.h
+#include "raylib.h"
+#include "globals.h"
+#include "player.h"
+#include "level.h"
+#include "enemy.h"
+#include "world.h"
+#include "alloc_tracker.h"
+
+void apply_deferred_graphics() {
+    // The quality can only change here, as ticks read it too
+    if (update_quality_governor()) {
+        is_level_graphics_stale = true;
+    }
+
+    // Everything here needs the GPU or the window, which only the main thread may use
+    if (IsWindowResized() || is_level_graphics_stale) {
+        derive_graphics_metrics_from_loaded_level();
+        invalidate_static_tiles();
+        is_level_graphics_stale = false;
+    }
+
+    if (is_victory_background_stale) {
+        create_victory_menu_background();
+        is_victory_background_stale = false;
+    }
+
+    // Escape quits the game from the main menu, and pauses it everywhere else
+    SetExitKey(game_state == MENU_STATE ? KEY_ESCAPE : 0);
+}
+
+void capture_render_snapshot() {
+    Player* player = Player::getInstance();
+    Level* level = Level::getInstance();
+    World* world = World::getInstance();
+    frame_snapshot &snapshot = render_snapshot;
+
+    snapshot.state = game_state;
+    snapshot.frame = game_frame;
+    snapshot.show_stats_overlay = show_stats_overlay;
+
+    snapshot.player_position = player->getPosition();
+    snapshot.player_texture = get_player_texture();
+    snapshot.lives = player->getLives();
+    snapshot.score = player->getTotalScore();
+    snapshot.timer = timer;
+    snapshot.hud_coin_texture = coin_sprite.frames[get_sprite_frame_index(coin_sprite)];
+
+    // The vectors keep their capacity, so after the first few frames copying into them does not allocate
+    snapshot.items.clear();
+    world->forEach(PICKUP_COMPONENT | POSITION_COMPONENT | ANIMATION_COMPONENT, [&](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            const animation_component &animation = group.animations[i];
+            snapshot.items.push_back({group.positions[i], animation.source->frames[animation.frame]});
+        }
+    });
+    for (const auto &exit : level->getExitPositions()) {
+        Vector2 position = {static_cast<float>(exit.column), static_cast<float>(exit.row)};
+        snapshot.items.push_back({position, exit_image});
+    }
+
+    snapshot.enemies.clear();
+    world->forEach(ENEMY_COMPONENT | POSITION_COMPONENT | ANIMATION_COMPONENT, [&](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            const animation_component &animation = group.animations[i];
+            snapshot.enemies.push_back({group.positions[i], animation.source->frames[animation.frame]});
+        }
+    });
+
+    snapshot.entity_count = world->getEntityCount();
+    snapshot.archetype_count = world->getArchetypeCount();
+    snapshot.stage_count = system_scheduler.getStageCount();
+    snapshot.chase_field_searches = Enemy::getChaseField().getSearchCount();
+    snapshot.level_arena_stats = level->getArena().getStats();
+}
+
+void sync_render_state() {
+    // The point between two ticks at which nothing is simulating, so the main thread may read the game freely
+    apply_deferred_graphics();
+    capture_render_snapshot();
+    bake_visible_static_tiles(render_snapshot.player_position);
+    update_memory_accounts();
+}
+
+void run_update_worker() {
+    std::unique_lock<std::mutex> lock(update_tick_mutex);
+    while (true) {
+        update_tick_requested.wait(lock, [] { return is_update_tick_running || !is_update_worker_running; });
+        if (!is_update_worker_running) return;
+
+        lock.unlock();
+        {
+            AllocationTracker::Zone zone(UPDATE_ZONE);
+            update_game();
+        }
+        lock.lock();
+
+        is_update_tick_running = false;
+        update_tick_finished.notify_one();
+    }
+}
+
+void start_update_worker() {
+    if (!launch_options.pipelined) return;
+
+    is_update_worker_running = true;
+    update_worker = std::thread(run_update_worker);
+}
+
+void stop_update_worker() {
+    if (!update_worker.joinable()) return;
+
+    finish_update_tick();
+    {
+        std::lock_guard<std::mutex> lock(update_tick_mutex);
+        is_update_worker_running = false;
+    }
+    update_tick_requested.notify_one();
+    update_worker.join();
+}
+
+void start_update_tick() {
+    // The tick runs on the worker while the main thread draws the snapshot of the previous one
+    {
+        std::lock_guard<std::mutex> lock(update_tick_mutex);
+        is_update_tick_running = true;
+    }
+    update_tick_requested.notify_one();
+}
+
+void finish_update_tick() {
+    std::unique_lock<std::mutex> lock(update_tick_mutex);
+    update_tick_finished.wait(lock, [] { return !is_update_tick_running; });
+}
+
+#endif // PIPELINE_H
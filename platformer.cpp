@@ -6,93 +6,121 @@
 #include "player.h"
 #include "enemy.h"
 #include "graphics.h"
+#include "draw_list.h"
+#include "audio.h"
+#include "input.h"
+#include "latency.h"
+#include "options.h"
+#include "systems.h"
+#include "alloc_tracker.h"
+#include "alloc_test.h"
+#include "pipeline.h"
+#include "quality.h"
+#include "memory.h"
+#include "capture.h"
 #include "assets.h"
 #include "utilities.h"
 
 void update_game() {
+    replay_input_events();
     game_frame++;
+    advance_animation_clock();
+
+    if (is_action_pressed(TOGGLE_STATS_ACTION)) {
+        show_stats_overlay = !show_stats_overlay;
+    }
+
     Player* player = Player::getInstance();
     Level* level = Level::getInstance();
 
     switch (game_state) {
         case MENU_STATE:
-            if (IsKeyPressed(KEY_ENTER)) {
-                SetExitKey(0);
+            if (is_action_pressed(CONFIRM_ACTION)) {
                 game_state = GAME_STATE;
-                level->loadLevelFromRLE("data/levels.rll");
+                level->loadLevelPack();
             }
             break;
 
         case GAME_STATE:
         {
-            if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) {
-                player->moveHorizontally(PLAYER_MOVEMENT_SPEED);
+            // The walking animation is only shown for ticks in which the player actually moved
+            player->setMoving(false);
+
+            // Moving as far as the keys were held for, so that a key let go of between two ticks moves the player
+            // for just the time it was down
+            float right = get_action_hold_fraction(MOVE_RIGHT_ACTION);
+            if (right > 0.0f) {
+                player->moveHorizontally(PLAYER_MOVEMENT_SPEED * right);
             }
 
-            if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) {
-                player->moveHorizontally(-PLAYER_MOVEMENT_SPEED);
+            float left = get_action_hold_fraction(MOVE_LEFT_ACTION);
+            if (left > 0.0f) {
+                player->moveHorizontally(-PLAYER_MOVEMENT_SPEED * left);
             }
 
             // Calculating collisions to decide whether the player is allowed to jump
             Vector2 playerPos = player->getPosition();
-            player->setOnGround(level->isColliding({playerPos.x, playerPos.y + 0.1f}, WALL));
+            player->setOnGround(level->isColliding<SOLID_TILE>({playerPos.x, playerPos.y + 0.1f}));
 
-            if ((IsKeyDown(KEY_UP) || IsKeyDown(KEY_W) || IsKeyDown(KEY_SPACE)) && player->isOnGround()) {
+            if (is_action_down(JUMP_ACTION) && player->isOnGround()) {
                 player->setYVelocity(-JUMP_STRENGTH);
             }
 
+            Enemy::updateChaseField();
+            run_systems();
             player->update();
-            Enemy::updateAll();
 
-            if (IsKeyPressed(KEY_ESCAPE)) {
+            if (is_action_pressed(PAUSE_ACTION)) {
                 game_state = PAUSED_STATE;
             }
             break;
         }
 
         case PAUSED_STATE:
-            if (IsKeyPressed(KEY_ESCAPE)) {
+            if (is_action_pressed(PAUSE_ACTION)) {
                 game_state = GAME_STATE;
             }
             break;
 
         case DEATH_STATE:
             player->updateGravity();
+            animation_system();
 
-            if (IsKeyPressed(KEY_ENTER)) {
+            if (is_action_pressed(CONFIRM_ACTION)) {
                 if (player->getLives() > 0) {
                     level->loadLevel(0);
                     game_state = GAME_STATE;
                 }
                 else {
                     game_state = GAME_OVER_STATE;
-                    PlaySound(game_over_sound);
+                    play_sound(GAME_OVER_SOUND);
                 }
             }
             break;
 
         case GAME_OVER_STATE:
-            if (IsKeyPressed(KEY_ENTER)) {
+            if (is_action_pressed(CONFIRM_ACTION)) {
                 level->resetLevelIndex();
                 player->resetStats();
                 game_state = GAME_STATE;
-                level->loadLevelFromRLE("data/levels.rll");
+                level->loadLevelPack();
             }
             break;
 
         case VICTORY_STATE:
-            if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) {
+            if (is_action_pressed(CONFIRM_ACTION) || is_action_pressed(PAUSE_ACTION)) {
                 level->resetLevelIndex();
                 player->resetStats();
                 game_state = MENU_STATE;
-                SetExitKey(KEY_ESCAPE);
             }
             break;
     }
 }
 
 void draw_game() {
-    switch(game_state) {
+    reset_draw_stats();
+
+    switch(render_snapshot.state) {
         case MENU_STATE:
             ClearBackground(BLACK);
             draw_menu();
@@ -103,6 +131,8 @@ void draw_game() {
             draw_parallax_background();
             draw_level();
             draw_game_overlay();
+            flush_scene();
+            flush_draw_list();
             break;
 
         case DEATH_STATE:
@@ -124,35 +154,112 @@ void draw_game() {
             draw_victory_menu();
             break;
     }
+
+    draw_stats_overlay();
 }
 
-int main() {
-    SetConfigFlags(FLAG_VSYNC_HINT);
+int main(int argc, char **argv) {
+    parse_launch_options(argc, argv);
+
+    if (launch_options.alloc_test && !AllocationTracker::isEnabled()) {
+        TraceLog(LOG_ERROR, "ALLOC TEST: The game has to be built with PLATFORMER_TRACK_ALLOCATIONS=ON");
+        return 1;
+    }
+
+    if (launch_options.vsync) {
+        SetConfigFlags(FLAG_VSYNC_HINT);
+    }
     InitWindow(1024, 480, "Platformer");
-    SetTargetFPS(60);
+    // With input polling, the frames are paced by the polling instead
+    SetTargetFPS(launch_options.alloc_test || launch_options.poll_input ? 0 : TARGET_FRAME_RATE);
     HideCursor();
 
     load_fonts();
     load_images();
     load_sounds();
 
+    register_systems();
+    register_memory_accounts();
+    system_scheduler.start(SYSTEM_WORKER_COUNT);
+    start_update_worker();
+    start_frame_capture();
+
     Player::getInstance()->init();
     Player::getInstance()->spawn();
     Enemy::spawnAll();
     derive_graphics_metrics_from_loaded_level();
 
     timer = MAX_LEVEL_TIME;
+    draw_list.reserve(DRAW_LIST_INITIAL_CAPACITY);
+
+    sync_render_state();
 
     while (!WindowShouldClose()) {
+        // The tick started while the previous frame was drawn has to be done before anything reads the game
+        finish_update_tick();
+        if (is_allocation_test_over()) break;
+
+        begin_allocation_frame();
+
+        if (launch_options.alloc_test) {
+            script_allocation_test_input();
+        }
+        else {
+            sample_input();
+        }
+        if (launch_options.late_input) {
+            wait_for_late_input();
+        }
+        begin_frame_timing();
+        frame_arena.reset();
+
+        if (!launch_options.pipelined) {
+            latch_tick_input();
+            AllocationTracker::Zone zone(UPDATE_ZONE);
+            update_game();
+        }
+        consume_input();
+        {
+            AllocationTracker::Zone zone(DRAW_ZONE);
+            sync_render_state();
+        }
+
+        // When pipelined, the next tick is simulated while this one is drawn
+        if (launch_options.pipelined) {
+            latch_tick_input();
+            start_update_tick();
+        }
+
         BeginDrawing();
 
-        update_game();
-        draw_game();
+        {
+            AllocationTracker::Zone zone(DRAW_ZONE);
+            draw_game();
+        }
 
+        capture_frame();
+        mark_frame_submitted();
         EndDrawing();
+        end_frame_timing();
+        record_quality_frame_time();
+
+        if (launch_options.poll_input) {
+            poll_input_until_next_frame();
+        }
     }
 
+    stop_update_worker();
+    stop_frame_capture();
+    report_latency();
+    report_memory_accounts();
+    Level::getInstance()->getArena().logStats();
+    frame_arena.logStats();
+
     Level::getInstance()->unloadLevel();
+    system_scheduler.stop();
+    unload_static_tiles();
+    unload_scene_target();
+    unload_composed_background();
     unload_sounds();
     unload_images();
     unload_fonts();
@@ -160,5 +267,5 @@ int main() {
     CloseAudioDevice();
     CloseWindow();
 
-    return 0;
+    return finish_allocation_test();
 }
\ No newline at end of file
@@ -9,9 +9,7 @@
 Player* Player::instance = nullptr;
 
 Player::Player() :
-    y_velocity(0),
-    position({0, 0}),
-    is_on_ground(false),
+    entity(),
     is_looking_forward(true),
     is_moving(false),
     lives(3)
@@ -36,9 +34,11 @@ Player* Player::getInstance() {
 
 void Player::init() {
     // Initialize player values
-    y_velocity = 0;
-    position = {0, 0};
-    is_on_ground = false;
+    World* world = World::getInstance();
+    entity_id playerEntity = getEntity();
+    world->getPosition(playerEntity) = {0, 0};
+    world->getVelocity(playerEntity) = {0, 0};
+    world->getGravity(playerEntity) = {};
     is_looking_forward = true;
     is_moving = false;
     lives = getMaxLives();
@@ -58,10 +58,10 @@ void Player::resetStats() {
     }
 }
 
-void Player::incrementScore() {
-    PlaySound(coin_sound);
+void Player::incrementScore(int amount) {
+    play_sound(COIN_SOUND);
     int levelIndex = Level::getInstance()->getLevelIndex();
-    level_scores[levelIndex]++;
+    level_scores[levelIndex] += amount;
 }
 
 int Player::getTotalScore() {
@@ -85,28 +85,39 @@ int Player::getMaxLives() const {
     return MAX_LIVES;
 }
 
+entity_id Player::getEntity() {
+    World* world = World::getInstance();
+    if (!world->isAlive(entity)) {
+        entity = world->create(PLAYER_COMPONENT | POSITION_COMPONENT | VELOCITY_COMPONENT | GRAVITY_COMPONENT);
+    }
+    return entity;
+}
+
 Vector2 Player::getPosition() const {
-    return position;
+    World* world = World::getInstance();
+    return world->isAlive(entity) ? world->getPosition(entity) : Vector2{0, 0};
 }
 
 void Player::setPosition(Vector2 newPos) {
-    position = newPos;
+    World::getInstance()->getPosition(getEntity()) = newPos;
 }
 
 float Player::getYVelocity() const {
-    return y_velocity;
+    World* world = World::getInstance();
+    return world->isAlive(entity) ? world->getVelocity(entity).y : 0.0f;
 }
 
 void Player::setYVelocity(float velocity) {
-    y_velocity = velocity;
+    World::getInstance()->getVelocity(getEntity()).y = velocity;
 }
 
 bool Player::isOnGround() const {
-    return is_on_ground;
+    World* world = World::getInstance();
+    return world->isAlive(entity) && world->getGravity(entity).is_on_ground;
 }
 
 void Player::setOnGround(bool onGround) {
-    is_on_ground = onGround;
+    World::getInstance()->getGravity(getEntity()).is_on_ground = onGround;
 }
 
 bool Player::isLookingForward() const {
@@ -126,27 +137,22 @@ void Player::setMoving(bool moving) {
 }
 
 void Player::spawn() {
-    y_velocity = 0;
+    setYVelocity(0);
     Level* levelPtr = Level::getInstance();
-    const struct level& currentLevel = levelPtr->getCurrentLevel();
 
-    for (size_t row = 0; row < currentLevel.rows; ++row) {
-        for (size_t column = 0; column < currentLevel.columns; ++column) {
-            char cell = levelPtr->getLevelCell(row, column);
-
-            if (cell == PLAYER) {
-                position.x = column;
-                position.y = row;
-                levelPtr->setLevelCell(row, column, AIR);
-                return;
-            }
-        }
+    // The spawn point is found while the level is decoded, so there is no need to scan the grid
+    if (!levelPtr->hasSpawnPoint()) {
+        return;
     }
+
+    level_position spawnPoint = levelPtr->getSpawnPoint();
+    setPosition({static_cast<float>(spawnPoint.column), static_cast<float>(spawnPoint.row)});
+    levelPtr->setLevelCell(spawnPoint.row, spawnPoint.column, AIR);
 }
 
 void Player::kill() {
     // Decrement a life and reset all collected coins in the current level
-    PlaySound(player_death_sound);
+    play_sound(PLAYER_DEATH_SOUND);
     game_state = DEATH_STATE;
     lives--;
     int levelIndex = Level::getInstance()->getLevelIndex();
@@ -154,16 +160,12 @@ void Player::kill() {
 }
 
 void Player::moveHorizontally(float delta) {
-    // See if the player can move further without touching a wall;
-    // otherwise, prevent them from getting into a wall by rounding their position
-    float next_x = position.x + delta;
+    // Move as far as possible without getting into a wall, even if it is thinner than the step
     Level* levelPtr = Level::getInstance();
-
-    if (!levelPtr->isColliding({next_x, position.y}, WALL)) {
-        position.x = next_x;
-    }
-    else {
-        position.x = roundf(position.x);
+    Vector2 &position = World::getInstance()->getPosition(getEntity());
+    sweep_result sweep = levelPtr->sweepHorizontally<SOLID_TILE>(position, delta);
+    position = sweep.position;
+    if (sweep.is_blocked) {
         return;
     }
 
@@ -173,38 +175,22 @@ void Player::moveHorizontally(float delta) {
 }
 
 void Player::updateGravity() {
-    Level* levelPtr = Level::getInstance();
-
-    // Bounce downwards if approaching a ceiling with upwards velocity
-    if (levelPtr->isColliding({position.x, position.y - 0.1f}, WALL) && y_velocity < 0) {
-        y_velocity = CEILING_BOUNCE_OFF;
-    }
-
-    // Add gravity to player's y-position
-    position.y += y_velocity;
-    y_velocity += GRAVITY_FORCE;
-
-    // If the player is on ground, zero player's y-velocity
-    // If the player is *in* ground, pull them out by rounding their position
-    is_on_ground = levelPtr->isColliding({position.x, position.y + 0.1f}, WALL);
-    if (is_on_ground) {
-        y_velocity = 0;
-        position.y = roundf(position.y);
-    }
+    // The player is the only entity that falls, so this is the gravity system on its own,
+    // for when nothing else should move (e.g., while the player's body falls after dying)
+    gravity_system();
 }
 
 void Player::update() {
-    updateGravity();
+    // Runs after the systems moved everything and found what the player touches
     Level* levelPtr = Level::getInstance();
+    World* world = World::getInstance();
     const struct level& currentLevel = levelPtr->getCurrentLevel();
+    Vector2 position = getPosition();
 
-    // Interacting with other level elements
-    if (levelPtr->isColliding(position, COIN)) {
-        levelPtr->getCollider(position, COIN) = AIR; // Removes the coin
-        incrementScore();
-    }
+    // Interacting with other level elements, all found by a single look at the surrounding tiles
+    uint8_t touching = levelPtr->getCollidingTraits(position);
 
-    if (levelPtr->isColliding(position, EXIT)) {
+    if (touching & GOAL_TILE) {
         // Reward player for being swift
         if (timer > 0) {
             // For every 9 seconds remaining, award the player 1 coin
@@ -219,7 +205,12 @@ void Player::update() {
         else {
             // Allow the player to exit after the level timer goes to zero
             levelPtr->loadLevel(1);
-            PlaySound(exit_sound);
+            play_sound(EXIT_SOUND);
+
+            // The player is somewhere else in another level now, and the contacts belong to the old one
+            position = getPosition();
+            touching = levelPtr->getCollidingTraits(position);
+            player_contact_count = 0;
         }
     }
     else {
@@ -228,24 +219,42 @@ void Player::update() {
     }
 
     // Kill the player if they touch a spike or fall below the level
-    if (levelPtr->isColliding(position, SPIKE) || position.y > currentLevel.rows) {
+    if ((touching & LETHAL_TILE) || position.y > currentLevel.rows) {
         kill();
     }
 
+    // Pick up every coin the player touches, and see if they touch any enemies
+    bool isTouchingEnemy = false;
+    for (size_t i = 0; i < player_contact_count; ++i) {
+        entity_id contact = player_contacts[i];
+        if (!world->isAlive(contact)) continue;
+
+        const archetype &group = world->getArchetype(world->locate(contact).archetype);
+        if (group.has(PICKUP_COMPONENT)) {
+            incrementScore(world->getPickup(contact).score);
+            world->destroy(contact);
+        }
+        isTouchingEnemy = isTouchingEnemy || group.has(ENEMY_COMPONENT);
+    }
+
     // Upon colliding with an enemy...
-    if (Enemy::isCollidingWith(position)) {
+    if (isTouchingEnemy) {
         // ...check if their velocity is downwards...
-        if (y_velocity > 0) {
-            // ...if yes, award the player and kill the enemy
-            Enemy::removeColliding(position);
-            PlaySound(kill_enemy_sound);
+        if (getYVelocity() > 0) {
+            // ...if yes, award the player and kill every enemy they touch
+            for (size_t i = 0; i < player_contact_count; ++i) {
+                if (world->isAlive(player_contacts[i])) {
+                    world->destroy(player_contacts[i]);
+                }
+            }
+            play_sound(KILL_ENEMY_SOUND);
 
             incrementScore();
-            y_velocity = -BOUNCE_OFF_ENEMY;
+            setYVelocity(-BOUNCE_OFF_ENEMY);
         }
         else {
             // ...if not, kill the player
             kill();
         }
     }
-}
\ No newline at end of file
+}
@@ -3,13 +3,14 @@
 
 // This is player.h
 #include "raylib.h"
+#include "world.h"
 
+// The player's position, velocity and whether they stand on the ground live in their entity in the world,
+// where the systems move them like any other entity; the rest of the player's state is kept here
 class Player {
     static Player* instance;
 
-    Vector2 position;
-    float y_velocity;
-    bool is_on_ground;
+    entity_id entity;
     bool is_looking_forward;
     bool is_moving;
     int* level_scores;
@@ -31,12 +32,15 @@ public:
 
     // Player statistics management
     void resetStats();
-    void incrementScore();
+    void incrementScore(int amount = 1);
     int getTotalScore();
     int getLives() const;
     void setLives(int newLives);
     int getMaxLives() const;
 
+    // The player's entity, created when first needed
+    entity_id getEntity();
+
     // Player state getters and setters
     Vector2 getPosition() const;
     void setPosition(Vector2 newPos);
@@ -0,0 +1,68 @@
+#ifndef QUALITY_H
+#define QUALITY_H
+
+// This is quality.h
+#include "raylib.h"
+#include "globals.h"
+
+#include <algorithm>
+
+const quality_settings &get_quality_settings() {
+    return QUALITY_LEVELS[quality_governor.level];
+}
+
+void record_quality_frame_time() {
+    // The time between two presents, which includes waiting for the GPU, unlike the frame's work on the CPU
+    quality_governor_state &governor = quality_governor;
+    float frame_time_ms = static_cast<float>((last_present_time - governor.previous_present_time) * 1000.0);
+    governor.previous_present_time = last_present_time;
+    governor.frame_times_ms[governor.frame_count % QUALITY_WINDOW_FRAMES] = frame_time_ms;
+    ++governor.frame_count;
+}
+
+bool update_quality_governor() {
+    // Called between two ticks, as ticks read the settings too; returns whether the scene has to be resized
+    quality_governor_state &governor = quality_governor;
+    if (launch_options.fixed_quality || governor.frame_count < QUALITY_WINDOW_FRAMES) return false;
+
+    float sorted_ms[QUALITY_WINDOW_FRAMES];
+    std::copy(governor.frame_times_ms, governor.frame_times_ms + QUALITY_WINDOW_FRAMES, sorted_ms);
+    size_t index = static_cast<size_t>(QUALITY_PERCENTILE * (QUALITY_WINDOW_FRAMES - 1));
+    std::nth_element(sorted_ms, sorted_ms + index, sorted_ms + QUALITY_WINDOW_FRAMES);
+    governor.percentile_ms = sorted_ms[index];
+
+    // Stepping down happens as soon as the frames are too slow, while stepping up waits for a long stretch
+    // of frames on time, so that the quality doesn't flip back and forth around the budget
+    float budget_ms = 1000.0f / TARGET_FRAME_RATE;
+    size_t level = governor.level;
+    if (governor.percentile_ms > budget_ms * QUALITY_STEP_DOWN_LOAD) {
+        governor.frames_with_headroom = 0;
+        if (level > 0) {
+            --level;
+            governor.last_decision = "stepped down";
+        }
+    }
+    else if (governor.percentile_ms < budget_ms * QUALITY_STEP_UP_LOAD) {
+        if (++governor.frames_with_headroom >= QUALITY_STEP_UP_FRAMES && level + 1 < QUALITY_LEVEL_COUNT) {
+            ++level;
+            governor.last_decision = "stepped up";
+        }
+    }
+    else {
+        governor.frames_with_headroom = 0;
+    }
+
+    if (level == governor.level) return false;
+
+    // The frames measured so far were drawn at the old quality
+    bool is_rescaled = QUALITY_LEVELS[level].render_scale != QUALITY_LEVELS[governor.level].render_scale;
+    governor.level = level;
+    governor.frame_count = 0;
+    governor.frames_with_headroom = 0;
+    governor.last_decision_frame = game_frame;
+    TraceLog(LOG_INFO, "QUALITY: %s to level %zu, the %.0fth percentile frame took %.1f ms",
+             governor.last_decision, level, QUALITY_PERCENTILE * 100.0f, governor.percentile_ms);
+    return is_rescaled;
+}
+
+#endif // QUALITY_H
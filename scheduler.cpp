@@ -0,0 +1,160 @@
+#include "scheduler.h"
+#include "world.h"
+#include "raylib.h"
+#include <stdexcept>
+
+// This is scheduler.cpp
+
+SystemScheduler::SystemScheduler() :
+    systems(),
+    system_count(0),
+    stage_count(0),
+    stage_generation(0),
+    active_workers(0),
+    is_stopping(false),
+    stage_jobs(),
+    stage_size(0),
+    next_job(0),
+    pending_jobs(0)
+{
+    // The workers are only started by start()
+}
+
+SystemScheduler::~SystemScheduler() {
+    stop();
+}
+
+void SystemScheduler::add(const system_info& system) {
+    if (system_count == MAX_SYSTEMS) {
+        TraceLog(LOG_ERROR, "SCHEDULER: Too many systems, cannot add %s", system.name);
+        throw std::runtime_error("Too many systems");
+    }
+    systems[system_count++] = system;
+}
+
+void SystemScheduler::start(size_t workerCount) {
+    stop();
+    is_stopping = false;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&SystemScheduler::workerLoop, this);
+    }
+    TraceLog(LOG_INFO, "SCHEDULER: %zu systems, %zu workers", system_count, workers.size());
+}
+
+void SystemScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        is_stopping = true;
+    }
+    wake_workers.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+bool SystemScheduler::conflicts(const system_info& a, const system_info& b) const {
+    // Two systems can run together if neither writes anything the other one touches...
+    bool sharesData = (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+    if (!sharesData) return false;
+
+    // ...or if they never run over the same archetype
+    World* world = World::getInstance();
+    for (size_t i = 0; i < world->getArchetypeCount(); ++i) {
+        const archetype &group = world->getArchetype(i);
+        bool matchesA = group.has(a.required) && (group.components & a.excluded) == 0;
+        bool matchesB = group.has(b.required) && (group.components & b.excluded) == 0;
+        if (matchesA && matchesB) return true;
+    }
+    return false;
+}
+
+void SystemScheduler::run(bool isParallel) {
+    // Stages are recomputed on every run, as levels can bring new archetypes
+    stage_count = 0;
+    size_t stageStart = 0;
+    for (size_t i = 1; i <= system_count; ++i) {
+        bool endsStage = i == system_count;
+        for (size_t j = stageStart; j < i && !endsStage; ++j) {
+            endsStage = conflicts(systems[j], systems[i]);
+        }
+
+        if (endsStage) {
+            runStage(stageStart, i, isParallel);
+            stageStart = i;
+            ++stage_count;
+        }
+    }
+}
+
+void SystemScheduler::runStage(size_t first, size_t last, bool isParallel) {
+    if (!isParallel || workers.empty() || last - first < 2) {
+        for (size_t i = first; i < last; ++i) {
+            systems[i].run();
+        }
+        return;
+    }
+
+    {
+        // No worker may still be looking at the previous stage while this one is set up
+        std::unique_lock<std::mutex> lock(mutex);
+        stage_done.wait(lock, [this] { return active_workers == 0; });
+
+        stage_size = last - first;
+        for (size_t i = first; i < last; ++i) {
+            stage_jobs[i - first] = &systems[i];
+        }
+        pending_jobs = stage_size;
+        next_job = 0;
+        ++stage_generation;
+    }
+    wake_workers.notify_all();
+
+    // The calling thread takes jobs too, then waits for the workers to finish theirs
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    stage_done.wait(lock, [this] { return pending_jobs == 0; });
+}
+
+void SystemScheduler::runJobs() {
+    for (;;) {
+        size_t job = next_job.fetch_add(1);
+        if (job >= stage_size) break;
+
+        stage_jobs[job]->run();
+        if (pending_jobs.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            stage_done.notify_all();
+        }
+    }
+}
+
+void SystemScheduler::workerLoop() {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake_workers.wait(lock, [&] { return is_stopping || stage_generation != seenGeneration; });
+            if (is_stopping) return;
+            seenGeneration = stage_generation;
+            ++active_workers;
+        }
+
+        runJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active_workers;
+        }
+        stage_done.notify_all();
+    }
+}
+
+size_t SystemScheduler::getStageCount() const {
+    return stage_count;
+}
+
+size_t SystemScheduler::getWorkerCount() const {
+    return workers.size();
+}
@@ -0,0 +1,68 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// This is scheduler.h
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A system runs over every archetype that has all the `required` components and none of the `excluded` ones,
+// and declares which components it reads and writes so that the scheduler knows what it can run alongside
+struct system_info {
+    const char *name = "";
+    void (*run)() = nullptr;
+    uint32_t required = 0;
+    uint32_t excluded = 0;
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+};
+
+// Runs the systems in the order they were added, grouped into stages of systems that don't touch each other's
+// data; the systems of a stage can run at the same time on a pool of worker threads
+class SystemScheduler {
+    static const size_t MAX_SYSTEMS = 16;
+
+    std::array<system_info, MAX_SYSTEMS> systems;
+    size_t system_count;
+    size_t stage_count;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake_workers;
+    std::condition_variable stage_done;
+    uint64_t stage_generation;
+    size_t active_workers;
+    bool is_stopping;
+
+    // The stage being run; only changed while no worker is running it
+    std::array<const system_info*, MAX_SYSTEMS> stage_jobs;
+    size_t stage_size;
+    std::atomic<size_t> next_job;
+    std::atomic<size_t> pending_jobs;
+
+    bool conflicts(const system_info& a, const system_info& b) const;
+    void runStage(size_t first, size_t last, bool isParallel);
+    void runJobs();
+    void workerLoop();
+
+public:
+    SystemScheduler();
+    ~SystemScheduler();
+
+    void add(const system_info& system);
+
+    void start(size_t workerCount);
+    void stop();
+
+    // Runs every system once; stages only go to the workers if `isParallel` is set and there are workers
+    void run(bool isParallel);
+
+    size_t getStageCount() const;
+    size_t getWorkerCount() const;
+};
+
+#endif // SCHEDULER_H
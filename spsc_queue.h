@@ -0,0 +1,46 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+// This is spsc_queue.h
+#include <atomic>
+#include <cstddef>
+
+// A fixed-capacity, lock-free queue for exactly one producer thread and one consumer thread.
+// Neither side ever blocks: pushing to a full queue or popping from an empty one simply fails.
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    T items[CAPACITY] = {};
+    alignas(64) std::atomic<size_t> head{0}; // Next item to pop, only advanced by the consumer
+    alignas(64) std::atomic<size_t> tail{0}; // Next slot to push to, only advanced by the producer
+
+public:
+    bool tryPush(const T& item) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+
+        items[currentTail & (CAPACITY - 1)] = item;
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = items[currentHead & (CAPACITY - 1)];
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,173 @@
+#ifndef SYSTEMS_H
+#define SYSTEMS_H
+
+// This is systems.h
+#include "raylib.h"
+#include "globals.h"
+#include "world.h"
+#include "level.h"
+#include "player.h"
+#include "enemy.h"
+
+#include <algorithm>
+
+void patrol_step(Vector2 &position, patrol_component &patrol) {
+    // Chasers fly off their span, everyone else only loses it when a tile on their row changes
+    bool isInsideSpan = position.y == patrol.span_y && position.x >= patrol.span_left && position.x <= patrol.span_right;
+    if (!patrol.has_span || !isInsideSpan) {
+        Enemy::updatePatrolSpan(position, patrol);
+    }
+
+    // Keep moving until running into a wall, then turn around; stops where sweepHorizontally() would
+    float target = position.x + (patrol.is_looking_right ? patrol.speed : -patrol.speed);
+    bool isBlocked = patrol.is_looking_right ? target > patrol.span_right : target < patrol.span_left;
+    position.x = isBlocked ? (patrol.is_looking_right ? patrol.span_right : patrol.span_left) : target;
+    patrol.is_looking_right = patrol.is_looking_right != isBlocked;
+}
+
+void gravity_system() {
+    Level* level = Level::getInstance();
+    World::getInstance()->forEach(POSITION_COMPONENT | VELOCITY_COMPONENT | GRAVITY_COMPONENT, [level](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            Vector2 &position = group.positions[i];
+            Vector2 &velocity = group.velocities[i];
+            gravity_component &gravity = group.gravities[i];
+
+            // Move by the y-velocity, stopping at the first ceiling or floor on the way
+            sweep_result sweep = level->sweepVertically<SOLID_TILE>(position, velocity.y);
+            position = sweep.position;
+            if (sweep.is_blocked && velocity.y < 0) {
+                // Bounce downwards off the ceiling
+                velocity.y = CEILING_BOUNCE_OFF;
+            }
+            else {
+                velocity.y += GRAVITY_FORCE;
+            }
+
+            // If on ground, zero the y-velocity and settle on it
+            gravity.is_on_ground = level->isColliding<SOLID_TILE>({position.x, position.y + 0.1f});
+            if (gravity.is_on_ground) {
+                velocity.y = 0;
+                position = level->sweepVertically<SOLID_TILE>(position, 0.1f).position;
+            }
+        }
+    });
+}
+
+void patrol_system() {
+    World::getInstance()->forEach(POSITION_COMPONENT | PATROL_COMPONENT, CHASE_COMPONENT, [](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            patrol_step(group.positions[i], group.patrols[i]);
+        }
+    });
+}
+
+void chase_system() {
+    Level* level = Level::getInstance();
+    const FlowField &field = Enemy::getChaseField();
+    World::getInstance()->forEach(POSITION_COMPONENT | PATROL_COMPONENT | CHASE_COMPONENT, [&](archetype &group) {
+        for (size_t i = 0; i < group.size(); ++i) {
+            Vector2 &position = group.positions[i];
+            patrol_component &patrol = group.patrols[i];
+            float speed = group.chases[i].speed;
+
+            // Step toward the neighbouring cell that is closest to the player, which is a single lookup in the field;
+            // chasers too far away from the player just patrol
+            level_position cell = {
+                static_cast<size_t>(std::max(0.0f, roundf(position.y))),
+                static_cast<size_t>(std::max(0.0f, roundf(position.x)))
+            };
+            level_position next;
+            if (!field.getNextCell(cell, next)) {
+                patrol_step(position, patrol);
+                continue;
+            }
+
+            // Heading for the next cell also lines the chaser up with it on the other axis, so it fits through gaps
+            float dx = std::clamp(static_cast<float>(next.column) - position.x, -speed, speed);
+            float dy = std::clamp(static_cast<float>(next.row) - position.y, -speed, speed);
+            position = level->sweepHorizontally<SOLID_TILE>(position, dx).position;
+            position = level->sweepVertically<SOLID_TILE>(position, dy).position;
+            if (dx != 0.0f) {
+                patrol.is_looking_right = dx > 0.0f;
+            }
+        }
+    });
+}
+
+void animation_system() {
+    // Nothing changes until the animation clock moves
+    if (animation_clock == last_animated_clock) return;
+    last_animated_clock = animation_clock;
+
+    World::getInstance()->forEach(ANIMATION_COMPONENT, [](archetype &group) {
+        for (auto &animation : group.animations) {
+            animation.frame = get_sprite_frame_index(*animation.source);
+        }
+    });
+}
+
+void contact_system() {
+    // Finds the pickups and enemies the player touches; the player deals with them after the systems ran
+    player_contact_count = 0;
+    Vector2 playerPos = Player::getInstance()->getPosition();
+    Rectangle playerHitbox = {playerPos.x, playerPos.y, 1.0f, 1.0f};
+
+    World::getInstance()->forEach(POSITION_COMPONENT, PLAYER_COMPONENT, [&](archetype &group) {
+        if ((group.components & (PICKUP_COMPONENT | ENEMY_COMPONENT)) == 0) return;
+
+        for (size_t i = 0; i < group.size() && player_contact_count < MAX_PLAYER_CONTACTS; ++i) {
+            Rectangle hitbox = {group.positions[i].x, group.positions[i].y, 1.0f, 1.0f};
+            if (CheckCollisionRecs(playerHitbox, hitbox)) {
+                player_contacts[player_contact_count++] = group.entities[i];
+            }
+        }
+    });
+}
+
+void register_systems() {
+    // The order matters only between systems that share data: contacts are found after everything moved
+    system_info gravity;
+    gravity.name = "gravity";
+    gravity.run = gravity_system;
+    gravity.required = POSITION_COMPONENT | VELOCITY_COMPONENT | GRAVITY_COMPONENT;
+    gravity.reads = gravity.writes = gravity.required;
+    system_scheduler.add(gravity);
+
+    system_info patrol;
+    patrol.name = "patrol";
+    patrol.run = patrol_system;
+    patrol.required = POSITION_COMPONENT | PATROL_COMPONENT;
+    patrol.excluded = CHASE_COMPONENT;
+    patrol.reads = patrol.writes = patrol.required;
+    system_scheduler.add(patrol);
+
+    system_info chase;
+    chase.name = "chase";
+    chase.run = chase_system;
+    chase.required = POSITION_COMPONENT | PATROL_COMPONENT | CHASE_COMPONENT;
+    chase.reads = chase.required;
+    chase.writes = POSITION_COMPONENT | PATROL_COMPONENT;
+    system_scheduler.add(chase);
+
+    system_info animation;
+    animation.name = "animation";
+    animation.run = animation_system;
+    animation.required = ANIMATION_COMPONENT;
+    animation.reads = animation.writes = ANIMATION_COMPONENT;
+    system_scheduler.add(animation);
+
+    system_info contact;
+    contact.name = "contact";
+    contact.run = contact_system;
+    contact.required = POSITION_COMPONENT;
+    contact.reads = POSITION_COMPONENT;
+    system_scheduler.add(contact);
+}
+
+void run_systems() {
+    // Handing the stages to the workers only pays off once there are enough entities to go around
+    system_scheduler.run(World::getInstance()->getEntityCount() >= PARALLEL_SYSTEMS_MIN_ENTITIES);
+}
+
+#endif // SYSTEMS_H
@@ -0,0 +1,71 @@
+#ifndef TILES_H
+#define TILES_H
+
+// This is tiles.h
+#include <array>
+#include <cstdint>
+
+inline const char WALL      = '#',
+                  WALL_DARK = '=',
+                  AIR       = '-',
+                  SPIKE     = '^',
+                  PLAYER    = '@',
+                  ENEMY     = '&',
+                  CHASER    = 'C',
+                  COIN      = '*',
+                  EXIT      = 'E';
+
+// What a tile does to whoever touches it; flags can be OR'ed to query several traits at once
+enum tile_trait : uint8_t {
+    SOLID_TILE       = 1 << 0, // Blocks movement
+    LETHAL_TILE      = 1 << 1, // Kills the player
+    COLLECTIBLE_TILE = 1 << 2, // Picked up by the player
+    GOAL_TILE        = 1 << 3, // Ends the level
+    DRAWABLE_TILE    = 1 << 4  // Drawn straight from the grid (baked into the static tile chunks)
+};
+
+enum tile_texture : uint8_t {
+    NO_TILE_TEXTURE,
+    WALL_TILE_TEXTURE,
+    WALL_DARK_TILE_TEXTURE,
+    SPIKE_TILE_TEXTURE
+};
+
+struct tile_traits {
+    uint8_t flags = 0;
+    tile_texture texture = NO_TILE_TEXTURE;
+    bool is_level_element = false; // Whether the tile may appear in a level file
+};
+
+constexpr std::array<tile_traits, 256> make_tile_traits() {
+    std::array<tile_traits, 256> traits = {};
+
+    traits[static_cast<unsigned char>(WALL)]      = { SOLID_TILE | DRAWABLE_TILE,  WALL_TILE_TEXTURE,      true };
+    traits[static_cast<unsigned char>(WALL_DARK)] = { DRAWABLE_TILE,               WALL_DARK_TILE_TEXTURE, true };
+    traits[static_cast<unsigned char>(AIR)]       = { 0,                           NO_TILE_TEXTURE,        true };
+    traits[static_cast<unsigned char>(SPIKE)]     = { LETHAL_TILE | DRAWABLE_TILE, SPIKE_TILE_TEXTURE,     true };
+    traits[static_cast<unsigned char>(COIN)]      = { COLLECTIBLE_TILE,            NO_TILE_TEXTURE,        true };
+    traits[static_cast<unsigned char>(EXIT)]      = { GOAL_TILE,                   NO_TILE_TEXTURE,        true };
+
+    // Spawn markers, replaced by air once the player and the enemies are spawned
+    traits[static_cast<unsigned char>(PLAYER)]    = { 0,                           NO_TILE_TEXTURE,        true };
+    traits[static_cast<unsigned char>(ENEMY)]     = { 0,                           NO_TILE_TEXTURE,        true };
+    traits[static_cast<unsigned char>(CHASER)]    = { 0,                           NO_TILE_TEXTURE,        true };
+
+    return traits;
+}
+
+inline constexpr std::array<tile_traits, 256> TILE_TRAITS = make_tile_traits();
+
+constexpr const tile_traits &get_tile_traits(char tile) {
+    return TILE_TRAITS[static_cast<unsigned char>(tile)];
+}
+
+constexpr bool has_tile_traits(char tile, uint8_t traits) {
+    return (get_tile_traits(tile).flags & traits) != 0;
+}
+
+static_assert(has_tile_traits(WALL, SOLID_TILE) && !has_tile_traits(WALL_DARK, SOLID_TILE),
+              "Only walls are solid, dark walls are background");
+
+#endif // TILES_H
@@ -1,7 +1,12 @@
 #ifndef UTILITIES_H
 #define UTILITIES_H
 
+#include "globals.h"
+
 #include <cstdlib>
+#include <cstdio>
+#include <cstdarg>
+#include <algorithm>
 
 float rand_from_to(float from, float to) {
     return from + static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX) * (to - from); // NOLINT(*-msc50-cpp)
@@ -11,4 +16,19 @@ float rand_up_to(float to) {
     return rand_from_to(0.0f, to);
 }
 
+const char *frame_format(const char *format, ...) {
+    // Formats into the frame arena, so the string stays valid until the next tick without touching the heap
+    va_list arguments;
+    va_start(arguments, format);
+    va_list arguments_copy;
+    va_copy(arguments_copy, arguments);
+    int length = std::vsnprintf(nullptr, 0, format, arguments_copy);
+    va_end(arguments_copy);
+
+    array_view<char> buffer = frame_arena.allocateArray<char>(static_cast<size_t>(std::max(length, 0)) + 1);
+    std::vsnprintf(buffer.data, buffer.size(), format, arguments);
+    va_end(arguments);
+    return buffer.data;
+}
+
 #endif // UTILITIES_H
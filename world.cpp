@@ -0,0 +1,190 @@
+#include "world.h"
+#include <cassert>
+
+// This is world.cpp
+
+// Initialize static instance
+World* World::instance = nullptr;
+
+World::World() :
+    first_free(UINT32_MAX),
+    entity_count(0)
+{
+    // Archetypes are added as entities with new sets of components are created
+}
+
+World* World::getInstance() {
+    if (instance == nullptr) {
+        instance = new World();
+    }
+    return instance;
+}
+
+size_t World::findOrAddArchetype(uint32_t components) {
+    for (size_t i = 0; i < archetypes.size(); ++i) {
+        if (archetypes[i].components == components) {
+            return i;
+        }
+    }
+
+    archetypes.emplace_back();
+    archetypes.back().components = components;
+    return archetypes.size() - 1;
+}
+
+entity_id World::create(uint32_t components) {
+    uint32_t index;
+    if (first_free != UINT32_MAX) {
+        index = first_free;
+        first_free = records[index].next_free;
+    }
+    else {
+        index = static_cast<uint32_t>(records.size());
+        records.emplace_back();
+    }
+
+    size_t archetypeIndex = findOrAddArchetype(components);
+    archetype &group = archetypes[archetypeIndex];
+
+    entity_record &record = records[index];
+    record.archetype = static_cast<uint32_t>(archetypeIndex);
+    record.row = static_cast<uint32_t>(group.size());
+    record.next_free = UINT32_MAX;
+    record.is_alive = true;
+
+    entity_id entity = {index, record.generation};
+    group.entities.push_back(entity);
+    if (components & POSITION_COMPONENT)  group.positions.push_back({0.0f, 0.0f});
+    if (components & VELOCITY_COMPONENT)  group.velocities.push_back({0.0f, 0.0f});
+    if (components & GRAVITY_COMPONENT)   group.gravities.emplace_back();
+    if (components & PATROL_COMPONENT)    group.patrols.emplace_back();
+    if (components & CHASE_COMPONENT)     group.chases.emplace_back();
+    if (components & PICKUP_COMPONENT)    group.pickups.emplace_back();
+    if (components & ANIMATION_COMPONENT) group.animations.emplace_back();
+
+    ++entity_count;
+    return entity;
+}
+
+void World::removeRow(archetype& group, size_t row) {
+    // Move the last row into the removed one to keep the arrays dense
+    size_t last = group.size() - 1;
+    if (row != last) {
+        group.entities[row] = group.entities[last];
+        if (group.components & POSITION_COMPONENT)  group.positions[row] = group.positions[last];
+        if (group.components & VELOCITY_COMPONENT)  group.velocities[row] = group.velocities[last];
+        if (group.components & GRAVITY_COMPONENT)   group.gravities[row] = group.gravities[last];
+        if (group.components & PATROL_COMPONENT)    group.patrols[row] = group.patrols[last];
+        if (group.components & CHASE_COMPONENT)     group.chases[row] = group.chases[last];
+        if (group.components & PICKUP_COMPONENT)    group.pickups[row] = group.pickups[last];
+        if (group.components & ANIMATION_COMPONENT) group.animations[row] = group.animations[last];
+        records[group.entities[row].index].row = static_cast<uint32_t>(row);
+    }
+
+    group.entities.pop_back();
+    if (group.components & POSITION_COMPONENT)  group.positions.pop_back();
+    if (group.components & VELOCITY_COMPONENT)  group.velocities.pop_back();
+    if (group.components & GRAVITY_COMPONENT)   group.gravities.pop_back();
+    if (group.components & PATROL_COMPONENT)    group.patrols.pop_back();
+    if (group.components & CHASE_COMPONENT)     group.chases.pop_back();
+    if (group.components & PICKUP_COMPONENT)    group.pickups.pop_back();
+    if (group.components & ANIMATION_COMPONENT) group.animations.pop_back();
+}
+
+void World::destroy(entity_id entity) {
+    if (!isAlive(entity)) return;
+
+    entity_record &record = records[entity.index];
+    removeRow(archetypes[record.archetype], record.row);
+
+    record.is_alive = false;
+    ++record.generation;
+    record.next_free = first_free;
+    first_free = entity.index;
+    --entity_count;
+}
+
+void World::destroyAll(uint32_t components) {
+    for (archetype &group : archetypes) {
+        if (!group.has(components)) continue;
+
+        // Destroying from the back doesn't move any other row
+        while (group.size() > 0) {
+            destroy(group.entities.back());
+        }
+    }
+}
+
+bool World::isAlive(entity_id entity) const {
+    return entity.index < records.size() &&
+           records[entity.index].is_alive &&
+           records[entity.index].generation == entity.generation;
+}
+
+entity_location World::locate(entity_id entity) const {
+    assert(isAlive(entity));
+    const entity_record &record = records[entity.index];
+    return {record.archetype, record.row};
+}
+
+archetype& World::getArchetype(size_t index) {
+    return archetypes[index];
+}
+
+size_t World::getArchetypeCount() const {
+    return archetypes.size();
+}
+
+size_t World::getEntityCount() const {
+    return entity_count;
+}
+
+size_t World::getStorageBytes() const {
+    size_t bytes = records.capacity() * sizeof(entity_record) + archetypes.capacity() * sizeof(archetype);
+    for (const archetype &group : archetypes) {
+        bytes += group.entities.capacity() * sizeof(entity_id) +
+                 group.positions.capacity() * sizeof(Vector2) +
+                 group.velocities.capacity() * sizeof(Vector2) +
+                 group.gravities.capacity() * sizeof(gravity_component) +
+                 group.patrols.capacity() * sizeof(patrol_component) +
+                 group.chases.capacity() * sizeof(chase_component) +
+                 group.pickups.capacity() * sizeof(pickup_component) +
+                 group.animations.capacity() * sizeof(animation_component);
+    }
+    return bytes;
+}
+
+Vector2& World::getPosition(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].positions[location.row];
+}
+
+Vector2& World::getVelocity(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].velocities[location.row];
+}
+
+gravity_component& World::getGravity(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].gravities[location.row];
+}
+
+patrol_component& World::getPatrol(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].patrols[location.row];
+}
+
+chase_component& World::getChase(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].chases[location.row];
+}
+
+pickup_component& World::getPickup(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].pickups[location.row];
+}
+
+animation_component& World::getAnimation(entity_id entity) {
+    entity_location location = locate(entity);
+    return archetypes[location.archetype].animations[location.row];
+}
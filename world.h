@@ -0,0 +1,148 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+// This is world.h
+#include "raylib.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+struct sprite;
+
+// An entity is only a handle; the generation tells a live entity apart from an older one that had the same index
+struct entity_id {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+enum component : uint32_t {
+    POSITION_COMPONENT  = 1 << 0,
+    VELOCITY_COMPONENT  = 1 << 1,
+    GRAVITY_COMPONENT   = 1 << 2,
+    PATROL_COMPONENT    = 1 << 3,
+    CHASE_COMPONENT     = 1 << 4,
+    PICKUP_COMPONENT    = 1 << 5,
+    ANIMATION_COMPONENT = 1 << 6,
+
+    // Tags, without any data
+    PLAYER_COMPONENT    = 1 << 7,
+    ENEMY_COMPONENT     = 1 << 8
+};
+
+struct gravity_component {
+    bool is_on_ground = false;
+};
+
+// The walls the enemy turns around at are looked up once, and again only when it leaves the span between them
+// or a tile changes on its row
+struct patrol_component {
+    bool is_looking_right = true;
+    float speed = 0.0f;
+    bool has_span = false;
+    float span_y = 0.0f;
+    float span_left = 0.0f, span_right = 0.0f;
+};
+
+struct chase_component {
+    float speed = 0.0f;
+};
+
+struct pickup_component {
+    int score = 1;
+};
+
+struct animation_component {
+    const sprite *source = nullptr;
+    size_t frame = 0;
+};
+
+// All the entities with exactly the same set of components, each component in its own dense array;
+// the arrays of the components the archetype doesn't have stay empty
+struct archetype {
+    uint32_t components = 0;
+    std::vector<entity_id> entities;
+    std::vector<Vector2> positions;
+    std::vector<Vector2> velocities;
+    std::vector<gravity_component> gravities;
+    std::vector<patrol_component> patrols;
+    std::vector<chase_component> chases;
+    std::vector<pickup_component> pickups;
+    std::vector<animation_component> animations;
+
+    size_t size() const { return entities.size(); }
+    bool has(uint32_t required) const { return (components & required) == required; }
+};
+
+struct entity_location {
+    size_t archetype = 0;
+    size_t row = 0;
+};
+
+class World {
+    static World* instance;
+
+    struct entity_record {
+        uint32_t archetype = 0;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        uint32_t next_free = UINT32_MAX;
+        bool is_alive = false;
+    };
+
+    // Records of destroyed entities are chained into a free list through `next_free` and reused,
+    // so destroying and creating entities during a level doesn't allocate
+    std::vector<entity_record> records;
+    uint32_t first_free;
+    size_t entity_count;
+
+    // Only ever appended to, so an archetype's index stays valid
+    std::vector<archetype> archetypes;
+
+    size_t findOrAddArchetype(uint32_t components);
+    void removeRow(archetype& group, size_t row);
+
+    // Private constructor for singleton pattern
+    World();
+
+public:
+    // Singleton accessor
+    static World* getInstance();
+
+    // Entity management
+    entity_id create(uint32_t components);
+    void destroy(entity_id entity);
+    void destroyAll(uint32_t components); // Every entity that has all the given components
+    bool isAlive(entity_id entity) const;
+
+    entity_location locate(entity_id entity) const;
+    archetype& getArchetype(size_t index);
+    size_t getArchetypeCount() const;
+    size_t getEntityCount() const;
+    size_t getStorageBytes() const; // Reserved by the records and every archetype's arrays
+
+    // Component access for a single entity, which must have the component
+    Vector2& getPosition(entity_id entity);
+    Vector2& getVelocity(entity_id entity);
+    gravity_component& getGravity(entity_id entity);
+    patrol_component& getPatrol(entity_id entity);
+    chase_component& getChase(entity_id entity);
+    pickup_component& getPickup(entity_id entity);
+    animation_component& getAnimation(entity_id entity);
+
+    // Visits every non-empty archetype that has all the required components and none of the excluded ones
+    template <typename Visitor>
+    void forEach(uint32_t required, uint32_t excluded, Visitor&& visit) {
+        for (archetype &group : archetypes) {
+            if (group.has(required) && (group.components & excluded) == 0 && group.size() > 0) {
+                visit(group);
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEach(uint32_t required, Visitor&& visit) {
+        forEach(required, 0, visit);
+    }
+};
+
+#endif // WORLD_H